@@ -0,0 +1,78 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#if !defined(BENCH_H)
+#define BENCH_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/* minimum amount of list bytes a repeated whole-list operation should touch */
+#define BENCH_MIN_BYTES (64U << 20)
+
+static bool bench_first = true;
+
+static inline uint64_t bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*
+ * Number of times to repeat an operation over a list of the given size, so
+ * that small lists are timed over enough iterations to be meaningful.
+ */
+static inline uint32_t bench_reps(size_t list_size)
+{
+	size_t reps = BENCH_MIN_BYTES / list_size;
+
+	if (reps < 4) {
+		return 4;
+	}
+	return reps > 100000 ? 100000 : (uint32_t)reps;
+}
+
+static inline void bench_begin(void)
+{
+	printf("[\n");
+}
+
+static inline void bench_end(void)
+{
+	printf("\n]\n");
+}
+
+/*
+ * Print one result as a JSON object. bytes is the amount of list data the ops
+ * operations processed in total, or 0 if a throughput makes no sense.
+ */
+static inline void bench_report(const char *op, const char *scenario,
+				size_t list_size, uint32_t entries,
+				uint64_t ops, uint64_t bytes, uint64_t ns)
+{
+	double secs;
+
+	if (ns == 0) {
+		ns = 1;
+	}
+	secs = ns / 1e9;
+
+	printf("%s  {\"op\": \"%s\", \"scenario\": \"%s\", "
+	       "\"list_size\": %zu, \"entries\": %" PRIu32 ", "
+	       "\"ops\": %" PRIu64 ", \"ns_per_op\": %.1f, "
+	       "\"bytes_per_s\": %.0f}",
+	       bench_first ? "" : ",\n", op, scenario, list_size, entries, ops,
+	       ops ? (double)ns / ops : 0.0, secs > 0 ? bytes / secs : 0.0);
+	bench_first = false;
+	fflush(stdout);
+}
+
+#endif /* BENCH_H */
@@ -0,0 +1,125 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "transfer_list.h"
+#include "transfer_list_parallel.h"
+
+#define MIB(x) ((size_t)(x) << 20)
+
+/* number of entries the list payload is spread over */
+#define ENTRIES 8U
+
+static const size_t list_sizes[] = { MIB(1), MIB(4), MIB(16), MIB(64) };
+static const unsigned int thread_counts[] = { 2, 4, 8, 16 };
+
+#define THREAD_COUNTS (sizeof(thread_counts) / sizeof(thread_counts[0]))
+
+static uint8_t *buf;
+
+static struct transfer_list_header *build(size_t list_size)
+{
+	struct transfer_list_header *tl = transfer_list_init(buf, list_size);
+	uint32_t data_size = (list_size - MIB(1) / 16) / ENTRIES;
+	struct transfer_list_entry *te;
+
+	data_size &= ~(uint32_t)(TRANSFER_LIST_GRANULE - 1);
+	for (uint32_t tag = 1; tag <= ENTRIES; tag++) {
+		te = transfer_list_add(tl, tag, data_size, NULL);
+		if (te == NULL) {
+			fprintf(stderr, "failed to build list\n");
+			exit(1);
+		}
+		memset(transfer_list_entry_data(te), tag, data_size);
+	}
+	transfer_list_update_checksum(tl);
+
+	return tl;
+}
+
+static void bench_serial(struct transfer_list_header *tl, size_t size)
+{
+	struct transfer_list_report report;
+	uint32_t reps = bench_reps(size);
+	volatile uint32_t sink = 0;
+	uint64_t t;
+
+	t = bench_now_ns();
+	for (uint32_t r = 0; r < reps; r++) {
+		sink += transfer_list_verify_checksum(tl);
+	}
+	bench_report("verify_checksum", "serial", size, ENTRIES, reps,
+		     (uint64_t)reps * tl->size, bench_now_ns() - t);
+
+	t = bench_now_ns();
+	for (uint32_t r = 0; r < reps; r++) {
+		sink += transfer_list_validate(tl, &report);
+	}
+	bench_report("validate", "serial", size, ENTRIES, reps,
+		     (uint64_t)reps * tl->size, bench_now_ns() - t);
+	(void)sink;
+}
+
+static void bench_parallel(struct transfer_list_header *tl, size_t size,
+			   unsigned int threads)
+{
+	struct transfer_list_report report;
+	uint32_t reps = bench_reps(size);
+	volatile uint32_t sink = 0;
+	char scenario[32];
+	uint64_t t;
+
+	snprintf(scenario, sizeof(scenario), "threads_%u", threads);
+
+	t = bench_now_ns();
+	for (uint32_t r = 0; r < reps; r++) {
+		sink += transfer_list_verify_checksum_parallel(tl, threads);
+	}
+	bench_report("verify_checksum", scenario, size, ENTRIES, reps,
+		     (uint64_t)reps * tl->size, bench_now_ns() - t);
+
+	t = bench_now_ns();
+	for (uint32_t r = 0; r < reps; r++) {
+		sink += transfer_list_validate_parallel(tl, &report, threads);
+	}
+	bench_report("validate", scenario, size, ENTRIES, reps,
+		     (uint64_t)reps * tl->size, bench_now_ns() - t);
+	(void)sink;
+}
+
+int main(void)
+{
+	struct transfer_list_header *tl;
+	size_t max = MIB(64);
+
+	buf = malloc(max);
+	if (!buf) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	/* threads beyond the online CPUs cannot speed the sum up */
+	fprintf(stderr, "online CPUs: %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+
+	bench_begin();
+	for (size_t i = 0; i < sizeof(list_sizes) / sizeof(list_sizes[0]);
+	     i++) {
+		tl = build(list_sizes[i]);
+		bench_serial(tl, list_sizes[i]);
+		for (size_t j = 0; j < THREAD_COUNTS; j++) {
+			bench_parallel(tl, list_sizes[i], thread_counts[j]);
+		}
+	}
+	bench_end();
+
+	free(buf);
+
+	return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+/*
+ * Built twice: as bench_hot_path calling into libtl.a, and as
+ * bench_hot_path_inline with LIBTL_INLINE defined, so that both builds of the
+ * hot-path functions can be compared.
+ */
+
+#include <stdlib.h>
+
+#include "bench.h"
+#include "transfer_list.h"
+
+#if defined(LIBTL_INLINE)
+#define BUILD "inline"
+#else
+#define BUILD "library"
+#endif
+
+#define LIST_SIZE ((size_t)1 << 20)
+
+/* number of lookups timed per list */
+#define FIND_OPS 1000U
+
+static const uint32_t entry_counts[] = { 10, 100, 1000, 10000 };
+
+static struct transfer_list_header *build(void *addr, uint32_t n)
+{
+	struct transfer_list_header *tl = transfer_list_init(addr, LIST_SIZE);
+
+	for (uint32_t tag = 1; tag <= n; tag++) {
+		if (!transfer_list_add(tl, tag, 8, NULL)) {
+			fprintf(stderr, "failed to build list\n");
+			exit(1);
+		}
+	}
+
+	return tl;
+}
+
+static void bench_walk(struct transfer_list_header *tl, uint32_t n)
+{
+	struct transfer_list_entry *te;
+	uint32_t reps = bench_reps(tl->size);
+	volatile uint64_t sink = 0;
+	uint64_t steps = 0, sum, t;
+
+	/* touch the data of every entry, as a consumer parsing them would */
+	t = bench_now_ns();
+	for (uint32_t r = 0; r < reps; r++) {
+		sum = 0;
+		te = NULL;
+		while ((te = transfer_list_next(tl, te)) != NULL) {
+			sum += *(uint8_t *)transfer_list_entry_data(te);
+			steps++;
+		}
+		sink += sum;
+	}
+	bench_report("next_walk", BUILD, LIST_SIZE, n, steps,
+		     (uint64_t)reps * tl->size, bench_now_ns() - t);
+	(void)sink;
+}
+
+static void bench_find(struct transfer_list_header *tl, uint32_t n)
+{
+	volatile uintptr_t sink = 0;
+	uint64_t t;
+
+	t = bench_now_ns();
+	for (uint32_t i = 0; i < FIND_OPS; i++) {
+		/* spread the lookups over the whole list */
+		sink += (uintptr_t)transfer_list_find(tl, i * 7919U % n + 1);
+	}
+	bench_report("find", BUILD, LIST_SIZE, n, FIND_OPS, 0,
+		     bench_now_ns() - t);
+	(void)sink;
+}
+
+int main(void)
+{
+	struct transfer_list_header *tl;
+	void *buf = malloc(LIST_SIZE);
+
+	if (!buf) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	bench_begin();
+	for (size_t i = 0; i < sizeof(entry_counts) / sizeof(entry_counts[0]);
+	     i++) {
+		tl = build(buf, entry_counts[i]);
+		bench_walk(tl, entry_counts[i]);
+		bench_find(tl, entry_counts[i]);
+	}
+	bench_end();
+
+	free(buf);
+
+	return 0;
+}
@@ -0,0 +1,286 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "transfer_list.h"
+
+#define KIB(x) ((size_t)(x) << 10)
+#define MIB(x) ((size_t)(x) << 20)
+
+/* number of lookups timed per list */
+#define FIND_OPS 1000U
+
+/* growth step of the set_data_size benchmark */
+#define GROW_STEP 64U
+
+static const size_t list_sizes[] = { KIB(4), KIB(64), MIB(1), MIB(16) };
+static const uint32_t entry_counts[] = { 1, 10, 100, 1000, 10000 };
+
+static uint8_t *buf[2];
+static uint8_t *payload;
+
+/*
+ * Data size of each of n entries filling 7/8 of a list, leaving room for
+ * entries to grow. Return 0 if the entries do not fit.
+ */
+static uint32_t entry_data_size(size_t list_size, uint32_t n)
+{
+	size_t budget;
+
+	budget = (list_size / 8 * 7 - sizeof(struct transfer_list_header)) / n;
+
+	budget &= ~(size_t)(TRANSFER_LIST_GRANULE - 1);
+	if (budget < 2 * sizeof(struct transfer_list_entry)) {
+		return 0;
+	}
+
+	return budget - sizeof(struct transfer_list_entry);
+}
+
+static struct transfer_list_header *build(void *addr, size_t list_size,
+					  uint32_t n, uint32_t data_size)
+{
+	struct transfer_list_header *tl = transfer_list_init(addr, list_size);
+
+	for (uint32_t tag = 1; tag <= n; tag++) {
+		if (!transfer_list_add(tl, tag, data_size, payload)) {
+			fprintf(stderr, "failed to build list\n");
+			exit(1);
+		}
+	}
+
+	return tl;
+}
+
+/*
+ * Remove every other entry, leaving the list full of holes.
+ */
+static void fragment(struct transfer_list_header *tl, uint32_t n)
+{
+	for (uint32_t tag = 1; tag <= n; tag += 2) {
+		transfer_list_rem(tl, transfer_list_find(tl, tag));
+	}
+}
+
+static void bench_add(size_t size, uint32_t n, uint32_t data_size)
+{
+	struct transfer_list_header *tl;
+	uint32_t reps = bench_reps(size);
+	uint64_t ns = 0, t;
+
+	for (uint32_t r = 0; r < reps; r++) {
+		tl = transfer_list_init(buf[0], size);
+
+		t = bench_now_ns();
+		for (uint32_t tag = 1; tag <= n; tag++) {
+			transfer_list_add(tl, tag, data_size, payload);
+		}
+		ns += bench_now_ns() - t;
+	}
+
+	bench_report("add", "packed", size, n, (uint64_t)reps * n,
+		     (uint64_t)reps * n * data_size, ns);
+}
+
+static void bench_find(const char *scenario, struct transfer_list_header *tl,
+		       size_t size, uint32_t n)
+{
+	volatile uintptr_t sink = 0;
+	uint64_t t;
+
+	t = bench_now_ns();
+	for (uint32_t i = 0; i < FIND_OPS; i++) {
+		/* spread the lookups over the whole list */
+		sink += (uintptr_t)transfer_list_find(tl, i * 7919U % n + 1);
+	}
+	bench_report("find", scenario, size, n, FIND_OPS, 0,
+		     bench_now_ns() - t);
+	(void)sink;
+}
+
+static void bench_walk(const char *scenario, struct transfer_list_header *tl,
+		       size_t size, uint32_t n)
+{
+	struct transfer_list_entry *te;
+	uint32_t reps = bench_reps(size);
+	uint64_t steps = 0, t;
+
+	t = bench_now_ns();
+	for (uint32_t r = 0; r < reps; r++) {
+		te = NULL;
+		while ((te = transfer_list_next(tl, te)) != NULL) {
+			steps++;
+		}
+	}
+	bench_report("next_walk", scenario, size, n, steps,
+		     (uint64_t)reps * tl->size, bench_now_ns() - t);
+}
+
+static void bench_whole_list(size_t size, uint32_t n, uint32_t data_size)
+{
+	struct transfer_list_header *tl = build(buf[0], size, n, data_size);
+	uint32_t reps = bench_reps(size);
+	volatile uint32_t sink = 0;
+	uint64_t t;
+
+	t = bench_now_ns();
+	for (uint32_t r = 0; r < reps; r++) {
+		sink += transfer_list_check_header(tl);
+	}
+	bench_report("check_header", "packed", size, n, reps,
+		     (uint64_t)reps * tl->size, bench_now_ns() - t);
+
+	t = bench_now_ns();
+	for (uint32_t r = 0; r < reps; r++) {
+		transfer_list_update_checksum(tl);
+	}
+	bench_report("update_checksum", "packed", size, n, reps,
+		     (uint64_t)reps * tl->size, bench_now_ns() - t);
+
+	t = bench_now_ns();
+	for (uint32_t r = 0; r < reps; r++) {
+		tl = transfer_list_relocate(tl, buf[(r + 1) % 2], size);
+	}
+	bench_report("relocate", "packed", size, n, reps,
+		     (uint64_t)reps * tl->size, bench_now_ns() - t);
+	(void)sink;
+}
+
+static void bench_set_data_size(size_t size, uint32_t n, uint32_t data_size)
+{
+	struct transfer_list_header *tl = build(buf[0], size, n, data_size);
+	struct transfer_list_entry *te = transfer_list_find(tl, n / 2 + 1);
+	uint32_t grows = (size / 8) / GROW_STEP;
+	uint64_t moved = 0, t;
+
+	if (grows > 1000) {
+		grows = 1000;
+	}
+
+	/* every step moves all entries behind the middle one */
+	t = bench_now_ns();
+	for (uint32_t i = 0; i < grows; i++) {
+		moved += tl->size - ((uintptr_t)te - (uintptr_t)tl);
+		transfer_list_set_data_size(tl, te, te->data_size + GROW_STEP);
+	}
+	bench_report("set_data_size", "grow_middle", size, n, grows, moved,
+		     bench_now_ns() - t);
+}
+
+/*
+ * Remove the entries in te[] from first to last, or the other way round. The
+ * entries do not move when others are removed, so the pointers stay valid.
+ */
+static uint64_t rem_entries(struct transfer_list_header *tl,
+			    struct transfer_list_entry **te, uint32_t n,
+			    bool backwards)
+{
+	uint64_t t = bench_now_ns();
+
+	for (uint32_t i = 0; i < n; i++) {
+		transfer_list_rem(tl, te[backwards ? n - 1 - i : i]);
+	}
+
+	return bench_now_ns() - t;
+}
+
+static uint32_t collect(struct transfer_list_header *tl,
+			struct transfer_list_entry **te)
+{
+	struct transfer_list_entry *it = NULL;
+	uint32_t n = 0;
+
+	while ((it = transfer_list_next(tl, it)) != NULL) {
+		if (it->tag_id != TL_TAG_EMPTY) {
+			te[n++] = it;
+		}
+	}
+
+	return n;
+}
+
+static void bench_rem(size_t size, uint32_t n, uint32_t data_size)
+{
+	struct transfer_list_entry **te = malloc(n * sizeof(*te));
+	struct transfer_list_header *tl;
+	uint32_t live;
+	uint64_t ns;
+
+	/* the entry in front of the removed one is found right away */
+	tl = build(buf[0], size, n, data_size);
+	live = collect(tl, te);
+	ns = rem_entries(tl, te, live, false);
+	bench_report("rem", "front", size, n, live, 0, ns);
+
+	/* finding the entry in front of the removed one walks the list */
+	tl = build(buf[0], size, n, data_size);
+	live = collect(tl, te);
+	ns = rem_entries(tl, te, live, true);
+	bench_report("rem", "back", size, n, live, 0, ns);
+
+	/* every removal merges with a hole in front of it */
+	tl = build(buf[0], size, n, data_size);
+	fragment(tl, n);
+	live = collect(tl, te);
+	ns = rem_entries(tl, te, live, true);
+	bench_report("rem", "fragmented", size, n, live, 0, ns);
+
+	free(te);
+}
+
+int main(void)
+{
+	struct transfer_list_header *tl;
+	uint32_t data_size;
+	size_t max = MIB(16);
+
+	buf[0] = malloc(max);
+	buf[1] = malloc(max);
+	payload = malloc(max);
+	if (!buf[0] || !buf[1] || !payload) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	memset(payload, 0xa5, max);
+
+	bench_begin();
+	for (size_t i = 0; i < sizeof(list_sizes) / sizeof(list_sizes[0]);
+	     i++) {
+		for (size_t j = 0;
+		     j < sizeof(entry_counts) / sizeof(entry_counts[0]); j++) {
+			size_t size = list_sizes[i];
+			uint32_t n = entry_counts[j];
+
+			data_size = entry_data_size(size, n);
+			if (data_size == 0) {
+				continue;
+			}
+
+			bench_add(size, n, data_size);
+
+			tl = build(buf[0], size, n, data_size);
+			bench_find("packed", tl, size, n);
+			bench_walk("packed", tl, size, n);
+			fragment(tl, n);
+			bench_find("fragmented", tl, size, n);
+			bench_walk("fragmented", tl, size, n);
+
+			bench_set_data_size(size, n, data_size);
+			bench_rem(size, n, data_size);
+			bench_whole_list(size, n, data_size);
+		}
+	}
+	bench_end();
+
+	free(payload);
+	free(buf[1]);
+	free(buf[0]);
+
+	return 0;
+}
@@ -9,6 +9,8 @@
 
 #include <stdint.h>
 
+#include <transfer_list_typed.h>
+
 struct param_header {
 	uint8_t type; /* type of the structure */
 	uint8_t version; /* version of this structure */
@@ -44,6 +46,15 @@ struct entry_point_info {
 	struct aapcs_params args;
 };
 
+/* Tie struct entry_point_info to the tag of the current execution state */
+#if defined(__aarch64__)
+TL_TAG_PAYLOAD_TYPE(TL_TAG_EXEC_EP_INFO64, struct entry_point_info);
+LIBTL_STATIC_ASSERT(sizeof(struct entry_point_info) == 0x58U,
+		    assert_entry_point_info64_size);
+#elif defined(__arm__)
+TL_TAG_PAYLOAD_TYPE(TL_TAG_EXEC_EP_INFO32, struct entry_point_info);
+#endif
+
 #define GET_SPSR_RW(mode) (((mode) >> 0x4U) & 0x1U)
 
 #endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <logging.h>
+
+/* Maximum number of arguments recorded per message */
+#define LIBTL_LOG_RING_MAX_ARGS 8U
+
+/* Maximum number of bytes recorded for a string argument */
+#define LIBTL_LOG_RING_MAX_STR 64U
+
+/*
+ * Deferred logger state. Messages are recorded as a format string pointer,
+ * a timestamp and the raw argument values in a caller-provided buffer, and
+ * only formatted when the buffer is drained. Format strings must therefore
+ * remain valid until then, which holds for the library's own messages. String
+ * arguments are copied, truncated to LIBTL_LOG_RING_MAX_STR bytes.
+ *
+ * Messages that do not fit into the buffer are dropped and counted. The ring
+ * is not safe for concurrent use.
+ *
+ * Only available when the library is built with the LIBTL_LOG_RING CMake
+ * option.
+ */
+struct libtl_log_ring {
+	uint8_t *buf;
+	size_t size; /* usable size of buf, a multiple of 8 */
+	size_t head; /* offset the next record is written at */
+	size_t tail; /* offset of the oldest record */
+	uint32_t dropped; /* messages dropped since the last drain */
+	uint64_t (*timestamp)(void); /* timestamp hook, may be NULL */
+};
+
+/**
+ * Initialize a deferred logger ring.
+ *
+ * @param[out] ring       Pointer to the ring to initialize.
+ * @param[in]  buf        Buffer to record messages in.
+ * @param[in]  size       Size of the buffer in bytes.
+ * @param[in]  timestamp  Function returning the timestamp to record with each
+ *                        message, or NULL to record 0.
+ *
+ * @return true on success, false if the buffer is too small.
+ */
+bool libtl_log_ring_init(struct libtl_log_ring *ring, void *buf, size_t size,
+			 uint64_t (*timestamp)(void));
+
+/**
+ * Route the library's log messages into a deferred logger ring.
+ *
+ * Registers a logger through libtl_register_logger() whose callbacks record
+ * into the given ring.
+ *
+ * @param[in] ring  Pointer to an initialized ring.
+ */
+void libtl_log_ring_register(struct libtl_log_ring *ring);
+
+/**
+ * Format and remove all messages recorded in a deferred logger ring.
+ *
+ * Calls emit once per message, oldest first. If messages were dropped, a final
+ * message reporting their number is emitted at level "WARN".
+ *
+ * @param[in] ring  Pointer to the ring to drain.
+ * @param[in] emit  Function receiving the level name, the recorded timestamp
+ *                  and the formatted message.
+ *
+ * @return Number of messages emitted.
+ */
+size_t libtl_log_ring_drain(struct libtl_log_ring *ring,
+			    void (*emit)(const char *level, uint64_t timestamp,
+					 const char *msg));
+
+#endif /* LOG_RING_H */
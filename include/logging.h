@@ -15,23 +15,73 @@ struct logger_interface {
 
 extern struct logger_interface *logger;
 
+/*
+ * Log levels for LIBTL_LOG_LEVEL. Messages above the configured level are
+ * compiled out: their arguments are not evaluated and their format strings do
+ * not end up in the binary. Verbose messages report successful operations and
+ * are printed through the info callback of the logger.
+ */
+#define LIBTL_LOG_LEVEL_NONE 0
+#define LIBTL_LOG_LEVEL_ERROR 1
+#define LIBTL_LOG_LEVEL_WARN 2
+#define LIBTL_LOG_LEVEL_INFO 3
+#define LIBTL_LOG_LEVEL_VERBOSE 4
+
+#ifndef LIBTL_LOG_LEVEL
+#define LIBTL_LOG_LEVEL LIBTL_LOG_LEVEL_VERBOSE
+#endif
+
+/*
+ * Stand-in for a filtered message. It is never called, but keeps the format
+ * string and arguments type checked and any variables they use referenced.
+ */
+static inline void __attribute__((format(printf, 1, 2)))
+libtl_log_discard(const char *fmt, ...)
+{
+	(void)fmt;
+}
+
+#define libtl_log_filtered(...)                          \
+	do {                                             \
+		if (0)                                   \
+			libtl_log_discard(__VA_ARGS__);  \
+	} while (0)
+
+#if LIBTL_LOG_LEVEL >= LIBTL_LOG_LEVEL_VERBOSE
+#define verbose(...) info(__VA_ARGS__)
+#else
+#define verbose(...) libtl_log_filtered(__VA_ARGS__)
+#endif
+
+#if LIBTL_LOG_LEVEL >= LIBTL_LOG_LEVEL_INFO
 #define info(...)                                               \
 	do {                                                    \
 		if ((logger != NULL) && (logger->info != NULL)) \
 			logger->info(__VA_ARGS__);              \
 	} while (0)
+#else
+#define info(...) libtl_log_filtered(__VA_ARGS__)
+#endif
 
+#if LIBTL_LOG_LEVEL >= LIBTL_LOG_LEVEL_WARN
 #define warn(...)                                               \
 	do {                                                    \
 		if ((logger != NULL) && (logger->warn != NULL)) \
 			logger->warn(__VA_ARGS__);              \
 	} while (0)
+#else
+#define warn(...) libtl_log_filtered(__VA_ARGS__)
+#endif
 
+#if LIBTL_LOG_LEVEL >= LIBTL_LOG_LEVEL_ERROR
 #define error(...)                                  \
 	do {                                        \
 		if (logger && logger->error)        \
 			logger->error(__VA_ARGS__); \
 	} while (0)
+#else
+#define error(...) libtl_log_filtered(__VA_ARGS__)
+#endif
 
 void libtl_register_logger(struct logger_interface *user_logger);
 
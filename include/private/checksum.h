@@ -0,0 +1,39 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Calculates the sum of all bytes in a memory region, modulo 256.
+ *
+ * The implementation is selected at build time via the
+ * `LIBTL_CHECKSUM_KERNEL` CMake option. All kernels return bit-identical
+ * results.
+ *
+ * @param addr Start of the memory region, no alignment is required.
+ * @param size Size of the memory region in bytes.
+ * @return The byte sum of the region.
+ */
+uint8_t libtl_byte_sum(const void *addr, size_t size);
+
+/**
+ * @brief Copies a memory region and calculates the sum of the copied bytes,
+ * modulo 256, in the same pass.
+ *
+ * The regions may overlap, as with memmove().
+ *
+ * @param dst Destination of the copy.
+ * @param src Source of the copy.
+ * @param size Number of bytes to copy.
+ * @return The byte sum of the copied region.
+ */
+uint8_t libtl_copy_sum(void *dst, const void *src, size_t size);
+
+#endif /* CHECKSUM_H */
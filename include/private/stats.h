@@ -0,0 +1,43 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <transfer_list.h>
+
+/*
+ * Instrumentation counters, only compiled in when the library is built with
+ * the LIBTL_STATS CMake option. Otherwise the macros expand to nothing.
+ */
+#if defined(LIBTL_STATS)
+extern struct transfer_list_stats libtl_stats;
+
+/*
+ * With LIBTL_PARALLEL, checksums are summed on worker threads and host tools
+ * may call the library from several threads, so the counters are only
+ * accessed atomically.
+ */
+#if defined(LIBTL_PARALLEL)
+#define libtl_stat_inc(var, n) \
+	((void)__atomic_fetch_add(&(var), (n), __ATOMIC_RELAXED))
+#define libtl_stat_load(var) __atomic_load_n(&(var), __ATOMIC_RELAXED)
+#define libtl_stat_store(var, val) \
+	__atomic_store_n(&(var), (val), __ATOMIC_RELAXED)
+#else
+#define libtl_stat_inc(var, n) ((void)((var) += (n)))
+#define libtl_stat_load(var) (var)
+#define libtl_stat_store(var, val) ((var) = (val))
+#endif
+
+#define libtl_stat_call(api) libtl_stat_inc(libtl_stats.calls[(api)], 1)
+#define libtl_stat_add(counter, n) libtl_stat_inc(libtl_stats.counter, (n))
+#else
+#define libtl_stat_call(api) ((void)0)
+#define libtl_stat_add(counter, n) ((void)0)
+#endif
+
+#endif /* STATS_H */
@@ -0,0 +1,33 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#ifndef VALIDATE_H
+#define VALIDATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <transfer_list.h>
+
+/**
+ * @brief Validates a transfer list like transfer_list_validate(), optionally
+ * with the checksum computed by a caller-provided function.
+ *
+ * @param tl Pointer to the transfer list.
+ * @param report Pointer to the report to fill in.
+ * @param list_sum Function returning the byte sum of the whole list, called
+ *        once after the header passed its checks, or NULL to sum each entry
+ *        as it is checked.
+ * @param arg Argument passed to list_sum.
+ * @return The operations valid for the list, TL_OPS_NON if it is invalid.
+ */
+enum transfer_list_ops
+libtl_validate(const struct transfer_list_header *tl,
+	       struct transfer_list_report *report,
+	       uint8_t (*list_sum)(const void *addr, size_t size, void *arg),
+	       void *arg);
+
+#endif /* VALIDATE_H */
@@ -7,6 +7,8 @@
 #ifndef TPM_EVENT_LOG_H
 #define TPM_EVENT_LOG_H
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include <transfer_list.h>
@@ -39,4 +41,60 @@ uint8_t *transfer_list_event_log_finish(struct transfer_list_header *tl,
 
 #define EVENT_LOG_RESERVED_BYTES 4U
 
+/* Smallest capacity the event log writer allocates for the log */
+#define EVENT_LOG_WRITER_MIN_CAPACITY 0x400U
+
+/*
+ * Streaming event log writer. It keeps the event log TE and the write cursor
+ * between extensions, and grows the TE geometrically ahead of need, so that
+ * logging n events costs amortized O(1) list operations each.
+ *
+ * Only growing the TE updates the list checksum, which then takes in the
+ * events written since the previous growth. The writer keeps a pointer to the
+ * TE, so the list must not be modified other than through the writer until
+ * transfer_list_event_log_writer_finish().
+ */
+struct transfer_list_event_log_writer {
+	struct transfer_list_header *tl;
+	struct transfer_list_entry *te; /* event log TE, or NULL */
+	size_t cursor; /* offset of the free space in the TE data */
+};
+
+/**
+ * Opens an event log writer on a transfer list.
+ *
+ * Continues an existing event log, or starts a new one on the first
+ * extension.
+ *
+ * @param writer     Pointer to the writer to initialize.
+ * @param tl         Pointer to the transfer list header.
+ * @return           true on success, false on invalid arguments.
+ */
+bool transfer_list_event_log_writer_init(
+	struct transfer_list_event_log_writer *writer,
+	struct transfer_list_header *tl);
+
+/**
+ * Appends space to the event log.
+ *
+ * @param writer     Pointer to the writer.
+ * @param req_size   Requested size (bytes)
+ * @return           Pointer to the new space, or NULL if the log cannot grow.
+ *                   The pointer is valid until the next extension.
+ */
+uint8_t *transfer_list_event_log_writer_extend(
+	struct transfer_list_event_log_writer *writer, size_t req_size);
+
+/**
+ * Finalizes the event log and closes the writer.
+ *
+ * Trims the event log to the data written and updates the checksum.
+ *
+ * @param writer     Pointer to the writer.
+ * @return           Pointer to start of log (past reserved bytes), or NULL
+ *                   if nothing was logged.
+ */
+uint8_t *transfer_list_event_log_writer_finish(
+	struct transfer_list_event_log_writer *writer);
+
 #endif /* TPM_EVENT_LOG_H */
@@ -49,6 +49,25 @@
 
 #define TL_FLAGS_HAS_CHECKSUM (1U << 0U)
 
+/*
+ * Flags private to LibTL, tracking the state of a list being modified:
+ * TL_FLAGS_LIBTL_RESERVED marks a list with an outstanding reservation, see
+ * transfer_list_reserve(), TL_FLAGS_LIBTL_BATCH a list in a batch session,
+ * see transfer_list_batch_begin(), and TL_FLAGS_LIBTL_DIRTY a list whose
+ * entry data may have been written by the caller since its checksum was
+ * updated.
+ *
+ * These bits are reserved by the Firmware Handoff specification, so they are
+ * only set while a list is being built and are clear in a finished list:
+ * transfer_list_commit(), transfer_list_reserve_abort(),
+ * transfer_list_batch_commit(), transfer_list_update_checksum() and the
+ * relocation calls all clear them, and transfer_list_set_handoff_args()
+ * refuses a list that still has a reservation or batch session open.
+ */
+#define TL_FLAGS_LIBTL_RESERVED (1U << 29U)
+#define TL_FLAGS_LIBTL_BATCH (1U << 30U)
+#define TL_FLAGS_LIBTL_DIRTY (1U << 31U)
+
 enum transfer_list_tag_id {
 	TL_TAG_EMPTY = 0,
 	TL_TAG_FDT = 1,
@@ -65,6 +84,19 @@ enum transfer_list_tag_id {
 	TL_TAG_SRAM_LAYOUT32 = 0x107,
 	TL_TAG_EXEC_EP_INFO32 = 0x108,
 	TL_TAG_GPT_ERROR_INFO = 0x109,
+	/* Non-standard tags private to LibTL */
+	TL_TAG_LIBTL_INDEX = 0xfff100,
+};
+
+enum transfer_list_placement {
+	TL_PLACE_APPEND, /* always add at the tail */
+	TL_PLACE_FIRST_FIT, /* reuse the first empty TE that fits */
+	TL_PLACE_BEST_FIT, /* reuse the smallest empty TE that fits */
+};
+
+enum transfer_list_resize_policy {
+	TL_RESIZE_STABLE, /* keep the TE in place, move the TEs behind it */
+	TL_RESIZE_MIN_MOVE, /* move whichever of the two is smaller */
 };
 
 enum transfer_list_ops {
@@ -111,6 +143,110 @@ struct __attribute__((packed)) transfer_list_entry {
 	 */
 };
 
+/*
+ * Data of a TL_TAG_LIBTL_INDEX entry: a table of the offsets (relative to the
+ * transfer list header) of all other non-empty TEs, sorted by tag_id and then
+ * by offset. The index is only valid while tl_size matches the size of the
+ * transfer list.
+ */
+struct transfer_list_index_entry {
+	uint32_t tag_id;
+	uint32_t offset;
+};
+
+struct transfer_list_index {
+	uint32_t count; /* number of used entries */
+	uint32_t tl_size; /* tl->size the index is valid for */
+	struct transfer_list_index_entry entries[];
+};
+
+/*
+ * Description of a transfer entry to be added by transfer_list_add_many()
+ */
+struct transfer_list_entry_desc {
+	uint32_t tag_id;
+	uint32_t data_size;
+	const void *data; /* data to copy, or NULL */
+	uint8_t alignment; /* data alignment as log2 value, 0 for none */
+};
+
+/* Number of preceding entries an iterator can step back to without a rescan */
+#define TRANSFER_LIST_ITER_DEPTH 4U
+
+/*
+ * Cursor over the entries of a transfer list. It remembers the offsets of the
+ * entries it passed most recently, so that stepping back and removing entries
+ * does not have to rescan the list from its head.
+ */
+struct transfer_list_iter {
+	struct transfer_list_header *tl;
+	struct transfer_list_entry *te; /* current TE, NULL before the first */
+	uint32_t hist[TRANSFER_LIST_ITER_DEPTH]; /* offsets of preceding TEs */
+	uint32_t top; /* next free slot in hist */
+	uint32_t depth; /* number of valid slots in hist */
+};
+
+/*
+ * Findings of transfer_list_validate()
+ */
+struct transfer_list_report {
+	uint32_t bad_offset; /* offset of the first malformed TE, 0 if none */
+	uint32_t entry_count; /* number of well formed TEs, void TEs included */
+	uint32_t empty_bytes; /* bytes taken up by void TEs */
+	uint8_t max_alignment; /* largest TE data alignment, as log2 value */
+	bool checksum_ok; /* the byte sum of the list is valid */
+};
+
+/*
+ * API functions whose calls are counted when the library is built with
+ * instrumentation, see transfer_list_stats_get()
+ */
+enum transfer_list_stat_api {
+	TL_STAT_INIT,
+	TL_STAT_RELOCATE,
+	TL_STAT_RELOCATE_COMPACT,
+	TL_STAT_CHECK_HEADER,
+	TL_STAT_VALIDATE,
+	TL_STAT_NEXT,
+	TL_STAT_PREV,
+	TL_STAT_UPDATE_CHECKSUM,
+	TL_STAT_VERIFY_CHECKSUM,
+	TL_STAT_SET_DATA_SIZE,
+	TL_STAT_REM,
+	TL_STAT_ADD,
+	TL_STAT_ADD_WITH_ALIGN,
+	TL_STAT_ADD_PLACED,
+	TL_STAT_ADD_MANY,
+	TL_STAT_RESERVE,
+	TL_STAT_COMMIT,
+	TL_STAT_RESIZE,
+	TL_STAT_COMPACT,
+	TL_STAT_FIND,
+	TL_STAT_FIND_NEXT,
+	TL_STAT_FIND_MANY,
+	TL_STAT_API_COUNT,
+};
+
+struct transfer_list_stats {
+	uint64_t calls[TL_STAT_API_COUNT]; /* calls per API function */
+	uint64_t bytes_summed; /* bytes run through the checksum calculation */
+	uint64_t bytes_moved; /* bytes moved within or copied into lists */
+	uint64_t entries_stepped; /* entries returned by transfer_list_next() */
+	uint64_t dummy_entries; /* void TEs created to fill gaps */
+};
+
+/*
+ * Read-only view of a transfer list that was fully validated once by
+ * transfer_list_view_open(). Its entries can be walked without the per-step
+ * bounds checks of transfer_list_next(), as long as the list is not modified
+ * while the view is in use.
+ */
+struct transfer_list_view {
+	struct transfer_list_header *tl;
+	uintptr_t end; /* address of the first byte after the list */
+	uint32_t count; /* number of entries */
+};
+
 /*
  * Provide a backward-compatible implementation of static_assert.
  * This keyword was introduced in C11, so it may be unavailable in
@@ -157,6 +293,26 @@ struct transfer_list_header *
 transfer_list_relocate(struct transfer_list_header *tl, void *addr,
 		       size_t max_size);
 
+/**
+ * Relocate a transfer list to a new memory region, dropping void entries.
+ *
+ * Like transfer_list_relocate(), but only copies entries that are not
+ * TL_TAG_EMPTY, packing them as transfer_list_compact() does, so that the
+ * relocated list can be smaller than the original. The checksum is computed
+ * while the entries are copied, so a source list whose checksum does not
+ * verify is refused. The regions may overlap.
+ *
+ * @param[in]  tl        Pointer to the existing transfer list.
+ * @param[in]  addr      Target address for relocation.
+ * @param[in]  max_size  Size of the target memory region in bytes.
+ *
+ * @return Pointer to the relocated transfer list, or NULL on error. The
+ *         original list is left untouched if the new region is too small.
+ */
+struct transfer_list_header *
+transfer_list_relocate_compact(struct transfer_list_header *tl, void *addr,
+			       size_t max_size);
+
 /**
  * Check the validity of a transfer list header.
  *
@@ -170,6 +326,23 @@ transfer_list_relocate(struct transfer_list_header *tl, void *addr,
 enum transfer_list_ops
 transfer_list_check_header(const struct transfer_list_header *tl);
 
+/**
+ * Fully validate a transfer list.
+ *
+ * Performs the checks of transfer_list_check_header() and additionally checks
+ * that every transfer entry is granule aligned, has a valid header size and
+ * lies within the list. The checksum is accumulated in the same pass over the
+ * list, so this reads the list from memory only once.
+ *
+ * @param[in]  tl      Pointer to the transfer list to verify.
+ * @param[out] report  Pointer to a report filled in with the findings.
+ *
+ * @return A transfer_list_ops code indicating valid operations.
+ */
+enum transfer_list_ops
+transfer_list_validate(const struct transfer_list_header *tl,
+		       struct transfer_list_report *report);
+
 /**
  * Get the next transfer entry in the list.
  *
@@ -180,9 +353,11 @@ transfer_list_check_header(const struct transfer_list_header *tl);
  *
  * @return Pointer to the next valid entry, or NULL on error or end of list.
  */
+#if !defined(LIBTL_INLINE)
 struct transfer_list_entry *
 transfer_list_next(struct transfer_list_header *tl,
 		   struct transfer_list_entry *last);
+#endif
 
 /**
  * Get the previous transfer entry in the list.
@@ -198,15 +373,100 @@ struct transfer_list_entry *
 transfer_list_prev(struct transfer_list_header *tl,
 		   struct transfer_list_entry *last);
 
+/**
+ * Initialize an iterator over a transfer list.
+ *
+ * The iterator starts before the first entry. It is invalidated by any
+ * modification of the list that is not made through the iterator itself.
+ *
+ * @param[out] it  Pointer to the iterator.
+ * @param[in]  tl  Pointer to the transfer list.
+ */
+void transfer_list_iter_init(struct transfer_list_iter *it,
+			     struct transfer_list_header *tl);
+
+/**
+ * Advance an iterator to the next transfer entry.
+ *
+ * @param[in,out] it  Pointer to the iterator.
+ *
+ * @return Pointer to the next valid entry, or NULL on error or end of list,
+ *         in which case the iterator starts over before the first entry.
+ */
+struct transfer_list_entry *
+transfer_list_iter_next(struct transfer_list_iter *it);
+
+/**
+ * Move an iterator back to the previous transfer entry.
+ *
+ * Takes constant time for up to TRANSFER_LIST_ITER_DEPTH consecutive steps,
+ * and rescans the list from its head beyond that.
+ *
+ * @param[in,out] it  Pointer to the iterator.
+ *
+ * @return Pointer to the previous entry, or NULL if the iterator was on the
+ *         first entry, in which case it is now positioned before it.
+ */
+struct transfer_list_entry *
+transfer_list_iter_prev(struct transfer_list_iter *it);
+
+/**
+ * Remove the current entry of an iterator.
+ *
+ * Behaves like transfer_list_rem() but uses the iterator to find the
+ * preceding entry. The iterator is left on the resulting empty entry, which
+ * may have been merged into the preceding one, so iteration can continue with
+ * transfer_list_iter_next().
+ *
+ * @param[in,out] it  Pointer to the iterator.
+ *
+ * @return true on success, false on error.
+ */
+bool transfer_list_rem_at(struct transfer_list_iter *it);
+
 /**
  * Update the checksum of a transfer list.
  *
  * Recomputes and updates the checksum field based on current contents.
+ * The mutating APIs of this library keep the checksum up to date
+ * incrementally. Data written into entries that were added without data or
+ * grown is accounted for by the next call modifying the list. This is needed
+ * after any other direct modification, and before handing the list over once
+ * entry data was written.
  *
  * @param[in,out] tl  Pointer to the transfer list to update.
  */
 void transfer_list_update_checksum(struct transfer_list_header *tl);
 
+/**
+ * Begin a batch session on a transfer list.
+ *
+ * Until transfer_list_batch_commit() is called, transfer_list_add(),
+ * transfer_list_add_with_align(), transfer_list_set_data_size() and
+ * transfer_list_rem() leave the checksum untouched, so the list fails
+ * checksum verification in the meantime. The session is recorded in the list
+ * header with TL_FLAGS_LIBTL_BATCH, so any number of lists can be in a batch
+ * session at once, but sessions on the same list cannot be nested. A list
+ * cannot be relocated while it is in a batch session.
+ *
+ * @param[in] tl  Pointer to the transfer list.
+ *
+ * @return true on success, false if @p tl is already in a batch session.
+ */
+bool transfer_list_batch_begin(struct transfer_list_header *tl);
+
+/**
+ * Commit a batch session on a transfer list.
+ *
+ * Ends the batch session opened by transfer_list_batch_begin() and computes
+ * the checksum of the list once.
+ *
+ * @param[in,out] tl  Pointer to the transfer list in the batch session.
+ *
+ * @return true on success, false if @p tl is not in a batch session.
+ */
+bool transfer_list_batch_commit(struct transfer_list_header *tl);
+
 /**
  * Verify the checksum of a transfer list.
  *
@@ -233,6 +493,28 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 				 struct transfer_list_entry *te,
 				 uint32_t new_data_size);
 
+/**
+ * Resize the data of a transfer entry, choosing how to make room.
+ *
+ * With TL_RESIZE_STABLE, this behaves like transfer_list_set_data_size(): the
+ * entry stays in place and the entries behind it are moved when it grows.
+ * With TL_RESIZE_MIN_MOVE, an entry that would require moving more data than
+ * its own size is moved to the end of the list instead, keeping its data at
+ * least as aligned as before, and its old place becomes an empty entry. Any
+ * pointers to the entry or its data must be updated from the returned entry.
+ *
+ * @param[in,out] tl            Pointer to the parent transfer list.
+ * @param[in,out] te            Pointer to the entry to resize.
+ * @param[in]     new_data_size New size of the entry data in bytes.
+ * @param[in]     policy        How to make room for the grown entry.
+ *
+ * @return Pointer to the resized entry, or NULL on error.
+ */
+struct transfer_list_entry *
+transfer_list_resize(struct transfer_list_header *tl,
+		     struct transfer_list_entry *te, uint32_t new_data_size,
+		     enum transfer_list_resize_policy policy);
+
 /**
  * Remove a transfer entry by marking it as empty.
  *
@@ -249,7 +531,12 @@ bool transfer_list_rem(struct transfer_list_header *tl,
 /**
  * Add a new transfer entry to the list.
  *
- * Appends a new entry with specified tag and data to the list tail.
+ * Appends a new entry with specified tag and data to the list tail. Without
+ * @p data, the entry data can be filled in through transfer_list_entry_data()
+ * afterwards. The next call modifying the list then recomputes the checksum
+ * over the whole list once. To fill entries in place at the cost of their
+ * own size only, use transfer_list_reserve() and transfer_list_commit(), or
+ * add them inside a batch session.
  *
  * @param[in,out] tl         Pointer to the transfer list.
  * @param[in]     tag_id     Tag identifier for the new entry.
@@ -281,6 +568,118 @@ transfer_list_add_with_align(struct transfer_list_header *tl, uint32_t tag_id,
 			     uint32_t data_size, const void *data,
 			     uint8_t alignment);
 
+/**
+ * Reserve a new transfer entry to be filled in place.
+ *
+ * Appends an entry with room for up to @p max_size bytes of data, which the
+ * caller writes directly through transfer_list_entry_data() instead of
+ * preparing it in a separate buffer. The list checksum is not valid until
+ * transfer_list_commit() or transfer_list_reserve_abort() is called. The
+ * reservation is recorded in the list header with TL_FLAGS_LIBTL_RESERVED, so
+ * each list can have one reservation outstanding, independently of other
+ * lists. Entries must not be moved or removed while it is.
+ *
+ * @param[in,out] tl         Pointer to the transfer list.
+ * @param[in]     tag_id     Tag identifier for the new entry.
+ * @param[in]     max_size   Maximum size of the entry data in bytes.
+ * @param[in]     alignment  Desired alignment (as log2 value).
+ *
+ * @return Pointer to the reserved entry, or NULL on error.
+ */
+struct transfer_list_entry *
+transfer_list_reserve(struct transfer_list_header *tl, uint32_t tag_id,
+		      uint32_t max_size, uint8_t alignment);
+
+/**
+ * Commit a reserved transfer entry.
+ *
+ * Sets the final data size of the entry returned by transfer_list_reserve()
+ * and accounts for its data in the checksum. Unused space is returned to the
+ * list if the entry is the last one, and left as an empty entry otherwise.
+ *
+ * @param[in,out] tl         Pointer to the transfer list.
+ * @param[in,out] te         Pointer to the reserved entry.
+ * @param[in]     data_size  Actual size of the entry data in bytes.
+ *
+ * @return true on success, false on error.
+ */
+bool transfer_list_commit(struct transfer_list_header *tl,
+			  struct transfer_list_entry *te, uint32_t data_size);
+
+/**
+ * Abort a reserved transfer entry.
+ *
+ * Drops the entry returned by transfer_list_reserve(), for producers that fail
+ * before its data is complete. Its space is returned to the list if it is the
+ * last entry, and left as an empty entry otherwise.
+ *
+ * @param[in,out] tl  Pointer to the transfer list.
+ * @param[in,out] te  Pointer to the reserved entry.
+ *
+ * @return true on success, false on error.
+ */
+bool transfer_list_reserve_abort(struct transfer_list_header *tl,
+				 struct transfer_list_entry *te);
+
+/**
+ * Add a new transfer entry, reusing the space of an empty entry if possible.
+ *
+ * Implements the optional first step of adding a TE: depending on @p place,
+ * the new entry is placed into the first or the smallest empty entry that can
+ * hold it at the requested alignment. The remainder of the empty entry is
+ * kept as smaller empty entries before and after the new one. If no empty
+ * entry fits, or @p place is TL_PLACE_APPEND, the entry is appended as by
+ * transfer_list_add_with_align().
+ *
+ * @param[in,out] tl         Pointer to the transfer list.
+ * @param[in]     tag_id     Tag identifier for the new entry.
+ * @param[in]     data_size  Size of the entry data in bytes.
+ * @param[in]     data       Pointer to the data to copy (can be NULL).
+ * @param[in]     alignment  Desired alignment (as log2 value).
+ * @param[in]     place      Placement policy.
+ *
+ * @return Pointer to the added entry, or NULL on error.
+ */
+struct transfer_list_entry *
+transfer_list_add_placed(struct transfer_list_header *tl, uint32_t tag_id,
+			 uint32_t data_size, const void *data,
+			 uint8_t alignment, enum transfer_list_placement place);
+
+/**
+ * Add several transfer entries to the list at once.
+ *
+ * Lays out all entries up front, including empty entries inserted to meet
+ * their data alignment as transfer_list_add_with_align() does, and updates
+ * the list header and checksum once. Either all entries are added or the
+ * list is left unchanged.
+ *
+ * @param[in,out] tl     Pointer to the transfer list.
+ * @param[in]     descs  Array of descriptions of the entries to add.
+ * @param[in]     n      Number of entries in @p descs.
+ *
+ * @return true on success, false if the entries do not fit or on error.
+ */
+bool transfer_list_add_many(struct transfer_list_header *tl,
+			    const struct transfer_list_entry_desc *descs,
+			    size_t n);
+
+/**
+ * Compact a transfer list in place.
+ *
+ * Slides all non-empty entries down over the empty entries left behind by
+ * transfer_list_rem() and transfer_list_set_data_size(), and shrinks the list
+ * accordingly. The data of each entry stays at least as aligned as before, up
+ * to the maximum alignment of the list, so small empty entries may remain to
+ * pad for alignment. Entries are moved, so any pointers into the list are
+ * invalidated. Fails while an entry reserved with transfer_list_reserve() is
+ * outstanding.
+ *
+ * @param[in,out] tl  Pointer to the transfer list.
+ *
+ * @return Number of bytes the list shrank by, 0 if it was not compacted.
+ */
+uint32_t transfer_list_compact(struct transfer_list_header *tl);
+
 /**
  * Find an entry in the transfer list by tag.
  *
@@ -292,19 +691,109 @@ transfer_list_add_with_align(struct transfer_list_header *tl, uint32_t tag_id,
  *
  * @return Pointer to the found entry, or NULL if not found.
  */
+#if !defined(LIBTL_INLINE)
 struct transfer_list_entry *transfer_list_find(struct transfer_list_header *tl,
 					       uint32_t tag_id);
+#endif
+
+/**
+ * Find the next entry in the transfer list with a given tag.
+ *
+ * Continue a search for entries with the specified tag id after a previously
+ * found entry. This allows enumerating all entries that share a tag, as
+ * transfer_list_find() only returns the first one.
+ *
+ * @param[in] tl      Pointer to the transfer list.
+ * @param[in] tag_id  Tag identifier to search for.
+ * @param[in] last    Entry to continue the search after, or NULL to start
+ *                    from the head of the list.
+ *
+ * @return Pointer to the next matching entry, or NULL if there is none.
+ */
+struct transfer_list_entry *
+transfer_list_find_next(struct transfer_list_header *tl, uint32_t tag_id,
+			struct transfer_list_entry *last);
+
+/**
+ * Find the first entries for several tags in a single pass.
+ *
+ * Walks the transfer list once (or uses the tag index if present) and stores
+ * the first entry found for tags[i] in out[i], or NULL if no such entry
+ * exists. Looking up K tags this way costs one walk instead of K.
+ *
+ * @param[in]  tl    Pointer to the transfer list.
+ * @param[in]  tags  Array of tag identifiers to search for.
+ * @param[in]  n     Number of elements in tags and out.
+ * @param[out] out   Array receiving the found entries.
+ *
+ * @return Number of tags for which an entry was found.
+ */
+size_t transfer_list_find_many(struct transfer_list_header *tl,
+			       const uint32_t *tags, size_t n,
+			       struct transfer_list_entry **out);
+
+/**
+ * Open a validated read-only view of a transfer list.
+ *
+ * Validates the list with transfer_list_validate(), which checks that every
+ * entry is well formed and that the entries cover the list up to its end. On
+ * success, the view can be used with transfer_list_view_next() and
+ * transfer_list_view_find(), which skip all bounds checks.
+ *
+ * @param[out] view  Pointer to the view to initialize.
+ * @param[in]  tl    Pointer to the transfer list.
+ *
+ * @return true on success, false if the list is invalid or not readable.
+ */
+bool transfer_list_view_open(struct transfer_list_view *view,
+			     struct transfer_list_header *tl);
+
+/**
+ * Create a tag index for the transfer list.
+ *
+ * Inserts a TL_TAG_LIBTL_INDEX entry at the start of the list, moving all
+ * existing entries up, and fills it with the offsets of all entries. While
+ * the index is present, transfer_list_add(), transfer_list_rem() and
+ * transfer_list_set_data_size() keep it up to date and transfer_list_find()
+ * uses a binary search instead of walking the list. If the index runs out of
+ * capacity, it goes stale and lookups fall back to walking the list.
+ *
+ * If the list already has an index, it is rebuilt instead. Fails while an
+ * entry reserved with transfer_list_reserve() is outstanding.
+ *
+ * @param[in,out] tl        Pointer to the transfer list.
+ * @param[in]     capacity  Number of entries the index can hold.
+ *
+ * @return Pointer to the index entry, or NULL on error.
+ */
+struct transfer_list_entry *
+transfer_list_index_create(struct transfer_list_header *tl, uint32_t capacity);
+
+/**
+ * Rebuild the tag index of a transfer list.
+ *
+ * Refreshes a stale index, for example after the list was modified without
+ * using this library or after entries were removed from a full index.
+ *
+ * @param[in,out] tl  Pointer to the transfer list.
+ *
+ * @return true if the list has an index and it is up to date, false otherwise.
+ */
+bool transfer_list_index_rebuild(struct transfer_list_header *tl);
 
 /**
  * Set handoff arguments in the entry point info structure.
  *
  * This function populates the provided entry point info structure with data
- * from the transfer list.
+ * from the transfer list. The checksum of a list whose entry data was filled
+ * in place is updated first. A list with an outstanding reservation or an
+ * open batch session is not handed over.
  *
- * @param[in] tl        Pointer to the transfer list.
+ * @param[in,out] tl    Pointer to the transfer list.
  * @param[out] ep_info  Pointer to the entry point info structure to populate.
  *
- * @return Pointer to the populated entry point info structure.
+ * @return Pointer to the populated entry point info structure, or NULL on
+ *         error.
  */
 struct entry_point_info *
 transfer_list_set_handoff_args(struct transfer_list_header *tl,
@@ -319,7 +808,9 @@ transfer_list_set_handoff_args(struct transfer_list_header *tl,
  *
  * @return Pointer to the data section, or NULL on error.
  */
+#if !defined(LIBTL_INLINE)
 void *transfer_list_entry_data(struct transfer_list_entry *entry);
+#endif
 
 /**
  * Ensure the transfer list is initialized.
@@ -348,5 +839,78 @@ void transfer_list_dump(struct transfer_list_header *tl);
  */
 void transfer_entry_dump(struct transfer_list_entry *te);
 
+/**
+ * Get the instrumentation counters of the library.
+ *
+ * The counters are only maintained when the library is built with the
+ * LIBTL_STATS CMake option. Calls that the library makes to its own API
+ * functions are counted as well, so that e.g. checksum rescans done on behalf
+ * of another operation show up. The counters are global. They are only
+ * updated atomically when the library is built with the LIBTL_PARALLEL option,
+ * otherwise the library must not be used from several threads at once while
+ * they are maintained.
+ *
+ * @param[out] stats  Pointer to receive a copy of the counters.
+ *
+ * @return true on success, false if instrumentation is not compiled in, in
+ *         which case all counters read as zero.
+ */
+bool transfer_list_stats_get(struct transfer_list_stats *stats);
+
+/**
+ * Reset all instrumentation counters of the library to zero.
+ */
+void transfer_list_stats_reset(void);
+
+/**
+ * Get the next entry of a validated transfer list view.
+ *
+ * @param[in] view  Pointer to a view opened by transfer_list_view_open().
+ * @param[in] last  Pointer to the previous entry, or NULL to start at the
+ *                  beginning.
+ *
+ * @return Pointer to the next entry, or NULL at the end of the list.
+ */
+static inline struct transfer_list_entry *
+transfer_list_view_next(const struct transfer_list_view *view,
+			const struct transfer_list_entry *last)
+{
+	uintptr_t va;
+
+	if (last == NULL) {
+		va = (uintptr_t)view->tl + view->tl->hdr_size;
+	} else {
+		va = ((uintptr_t)last + last->hdr_size + last->data_size +
+		      TRANSFER_LIST_GRANULE - 1U) &
+		     ~((uintptr_t)TRANSFER_LIST_GRANULE - 1U);
+	}
+
+	return (va < view->end) ? (struct transfer_list_entry *)va : NULL;
+}
+
+/**
+ * Find an entry in a validated transfer list view by tag.
+ *
+ * @param[in] view    Pointer to a view opened by transfer_list_view_open().
+ * @param[in] tag_id  Tag identifier to search for.
+ *
+ * @return Pointer to the first matching entry, or NULL if not found.
+ */
+static inline struct transfer_list_entry *
+transfer_list_view_find(const struct transfer_list_view *view, uint32_t tag_id)
+{
+	struct transfer_list_entry *te = NULL;
+
+	while ((te = transfer_list_view_next(view, te)) != NULL) {
+		if (te->tag_id == tag_id) {
+			break;
+		}
+	}
+
+	return te;
+}
+
+#include <transfer_list_inline.h>
+
 #endif /* __ASSEMBLER__ */
 #endif /* TRANSFER_LIST_H */
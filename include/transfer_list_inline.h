@@ -0,0 +1,111 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#ifndef TRANSFER_LIST_INLINE_H
+#define TRANSFER_LIST_INLINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <transfer_list.h>
+
+/*
+ * Inline implementations of the hot-path lookups, which the library's own
+ * transfer_list_next() and transfer_list_entry_data() are built from.
+ *
+ * When LIBTL_INLINE is defined, as the LIBTL_INLINE CMake option does for
+ * everything linking against the library, transfer_list_entry_data(),
+ * transfer_list_next() and transfer_list_find() are defined here as static
+ * inline functions instead, so that callers can inline and optimize list
+ * walks without relying on LTO.
+ *
+ * The inline transfer_list_find() always walks the list and ignores any tag
+ * index. It returns the same entry as the library function.
+ */
+
+static inline void *
+libtl_inline_entry_data(struct transfer_list_entry *entry)
+{
+	if (entry == NULL) {
+		return NULL;
+	}
+	return (uint8_t *)entry + entry->hdr_size;
+}
+
+static inline struct transfer_list_entry *
+libtl_inline_next(struct transfer_list_header *tl,
+		  struct transfer_list_entry *last)
+{
+	struct transfer_list_entry *te;
+	uintptr_t tl_ev, va, ev;
+	size_t sz;
+
+	if (tl == NULL) {
+		return NULL;
+	}
+
+	tl_ev = (uintptr_t)tl + tl->size;
+
+	if (last != NULL) {
+		/* check for overflow, then roundup to the next entry */
+		if (__builtin_add_overflow(last->hdr_size, last->data_size,
+					   &sz) ||
+		    __builtin_add_overflow((uintptr_t)last, sz, &va) ||
+		    __builtin_add_overflow(va, TRANSFER_LIST_GRANULE - 1U,
+					   &va)) {
+			return NULL;
+		}
+		va &= ~((uintptr_t)TRANSFER_LIST_GRANULE - 1U);
+	} else {
+		va = (uintptr_t)tl + tl->hdr_size;
+	}
+
+	te = (struct transfer_list_entry *)va;
+
+	if (((va + sizeof(*te)) > tl_ev) || ((te->hdr_size) < (sizeof(*te))) ||
+	    __builtin_add_overflow(te->hdr_size, te->data_size, &sz) ||
+	    __builtin_add_overflow(va, sz, &ev) || (ev > tl_ev)) {
+		return NULL;
+	}
+
+	return te;
+}
+
+static inline struct transfer_list_entry *
+libtl_inline_find(struct transfer_list_header *tl, uint32_t tag_id)
+{
+	struct transfer_list_entry *te = NULL;
+
+	while ((te = libtl_inline_next(tl, te)) != NULL) {
+		if (te->tag_id == tag_id) {
+			break;
+		}
+	}
+
+	return te;
+}
+
+#if defined(LIBTL_INLINE)
+static inline void *transfer_list_entry_data(struct transfer_list_entry *entry)
+{
+	return libtl_inline_entry_data(entry);
+}
+
+static inline struct transfer_list_entry *
+transfer_list_next(struct transfer_list_header *tl,
+		   struct transfer_list_entry *last)
+{
+	return libtl_inline_next(tl, last);
+}
+
+static inline struct transfer_list_entry *
+transfer_list_find(struct transfer_list_header *tl, uint32_t tag_id)
+{
+	return libtl_inline_find(tl, tag_id);
+}
+#endif /* LIBTL_INLINE */
+
+#endif /* TRANSFER_LIST_INLINE_H */
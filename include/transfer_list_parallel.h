@@ -0,0 +1,63 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#ifndef TRANSFER_LIST_PARALLEL_H
+#define TRANSFER_LIST_PARALLEL_H
+
+#include <stdbool.h>
+
+#include <transfer_list.h>
+
+/*
+ * Multi-threaded checksum and validation of large transfer lists, for host
+ * tools only. Only available when the library is built with the
+ * LIBTL_PARALLEL CMake option, which links it against pthreads.
+ */
+
+/*
+ * Smallest number of bytes handed to a worker thread. Lists shorter than twice
+ * this are checksummed on the calling thread only.
+ */
+#ifndef TRANSFER_LIST_PARALLEL_MIN_CHUNK
+#define TRANSFER_LIST_PARALLEL_MIN_CHUNK (1U << 20)
+#endif
+
+/**
+ * Verify the checksum of a transfer list, splitting it across threads.
+ *
+ * Same as transfer_list_verify_checksum(), with the byte sum split into
+ * chunks of at least TRANSFER_LIST_PARALLEL_MIN_CHUNK bytes, each summed by
+ * its own thread.
+ *
+ * @param[in] tl       Pointer to the transfer list.
+ * @param[in] threads  Maximum number of threads to use, including the calling
+ *                     one, or 0 to use one per online CPU.
+ *
+ * @return true if the checksum is valid or not in use, false otherwise.
+ */
+bool transfer_list_verify_checksum_parallel(
+	const struct transfer_list_header *tl, unsigned int threads);
+
+/**
+ * Validate a transfer list, splitting its checksum across threads.
+ *
+ * Same as transfer_list_validate(), with the checksum computed as by
+ * transfer_list_verify_checksum_parallel(). The entries are walked on the
+ * calling thread.
+ *
+ * @param[in]  tl       Pointer to the transfer list.
+ * @param[out] report   Pointer to the report to fill in.
+ * @param[in]  threads  Maximum number of threads to use, including the
+ *                      calling one, or 0 to use one per online CPU.
+ *
+ * @return The operations valid for the list, TL_OPS_NON if it is invalid.
+ */
+enum transfer_list_ops
+transfer_list_validate_parallel(const struct transfer_list_header *tl,
+				struct transfer_list_report *report,
+				unsigned int threads);
+
+#endif /* TRANSFER_LIST_PARALLEL_H */
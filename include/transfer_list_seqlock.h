@@ -0,0 +1,135 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#ifndef TRANSFER_LIST_SEQLOCK_H
+#define TRANSFER_LIST_SEQLOCK_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <transfer_list.h>
+
+/*
+ * Sequence counter guarding a transfer list that is modified by one core
+ * while others read it. It lives outside of the transfer list, in memory
+ * shared by the writer and the readers.
+ *
+ * The writer brackets every modification of the list with
+ * transfer_list_write_begin() and transfer_list_write_end(), which leave the
+ * counter odd while the list may be inconsistent. Readers never block the
+ * writer: they take a snapshot of what they need and retry if the counter
+ * changed meanwhile. Pointers into the list must not be kept across a retry,
+ * since modifications such as transfer_list_set_data_size() move entries.
+ *
+ * Writers must be serialized by the caller.
+ *
+ * Only available when the library is built with the LIBTL_SEQLOCK CMake
+ * option, as it relies on C11 atomics.
+ */
+struct transfer_list_seqlock {
+	_Atomic uint32_t seq;
+};
+
+/**
+ * Initialize a transfer list sequence counter.
+ *
+ * @param[out] lock  Pointer to the sequence counter.
+ */
+static inline void
+transfer_list_seqlock_init(struct transfer_list_seqlock *lock)
+{
+	atomic_init(&lock->seq, 0);
+}
+
+/**
+ * Mark the start of a modification of the guarded transfer list.
+ *
+ * @param[in] lock  Pointer to the sequence counter.
+ */
+static inline void
+transfer_list_write_begin(struct transfer_list_seqlock *lock)
+{
+	uint32_t seq = atomic_load_explicit(&lock->seq, memory_order_relaxed);
+
+	atomic_store_explicit(&lock->seq, seq + 1, memory_order_relaxed);
+	/* order the odd counter before any write to the list */
+	atomic_thread_fence(memory_order_release);
+}
+
+/**
+ * Mark the end of a modification of the guarded transfer list.
+ *
+ * @param[in] lock  Pointer to the sequence counter.
+ */
+static inline void transfer_list_write_end(struct transfer_list_seqlock *lock)
+{
+	uint32_t seq = atomic_load_explicit(&lock->seq, memory_order_relaxed);
+
+	atomic_store_explicit(&lock->seq, seq + 1, memory_order_release);
+}
+
+/**
+ * Start a read of the guarded transfer list, waiting for an ongoing
+ * modification to end.
+ *
+ * @param[in] lock  Pointer to the sequence counter.
+ *
+ * @return Sequence value to pass to transfer_list_read_retry().
+ */
+static inline uint32_t
+transfer_list_read_begin(struct transfer_list_seqlock *lock)
+{
+	uint32_t seq;
+
+	while ((seq = atomic_load_explicit(&lock->seq,
+					   memory_order_acquire)) & 1U) {
+		/* a modification is in progress */
+	}
+
+	return seq;
+}
+
+/**
+ * Check whether a read of the guarded transfer list has to be retried.
+ *
+ * @param[in] lock  Pointer to the sequence counter.
+ * @param[in] seq   Value returned by transfer_list_read_begin().
+ *
+ * @return true if the list was modified during the read and anything read
+ *         from it must be discarded.
+ */
+static inline bool transfer_list_read_retry(struct transfer_list_seqlock *lock,
+					    uint32_t seq)
+{
+	/* order the reads of the list before the counter check */
+	atomic_thread_fence(memory_order_acquire);
+
+	return atomic_load_explicit(&lock->seq, memory_order_relaxed) != seq;
+}
+
+/**
+ * Search for an entry by tag while another core may modify the transfer list,
+ * and copy out its data.
+ *
+ * The list is walked with every entry bounds checked, so a concurrent
+ * modification cannot make the walk leave the list, and the lookup is retried
+ * until it completes without one. The tag index is not used.
+ *
+ * @param[in]     tl      Pointer to the transfer list.
+ * @param[in]     lock    Pointer to the sequence counter guarding the list.
+ * @param[in]     tag_id  Tag identifier to search for.
+ * @param[out]    buf     Buffer to copy the entry data into.
+ * @param[in,out] size    Size of buf on entry, data size of the entry on
+ *                        return. At most the buffer size is copied.
+ *
+ * @return true if an entry was found, false otherwise.
+ */
+bool transfer_list_read_find(const struct transfer_list_header *tl,
+			     struct transfer_list_seqlock *lock,
+			     uint32_t tag_id, void *buf, uint32_t *size);
+
+#endif /* TRANSFER_LIST_SEQLOCK_H */
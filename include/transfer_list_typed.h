@@ -0,0 +1,114 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#ifndef TRANSFER_LIST_TYPED_H
+#define TRANSFER_LIST_TYPED_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <transfer_list.h>
+
+/*
+ * Typed access to entries with a fixed payload layout. Each tag is tied to
+ * its payload type with TL_TAG_PAYLOAD_TYPE(), and TL_GET() only compiles
+ * when the requested type is the one tied to the tag:
+ *
+ *	struct transfer_list_sram_layout64 *sram =
+ *		TL_GET(tl, TL_TAG_SRAM_LAYOUT64,
+ *		       struct transfer_list_sram_layout64);
+ *
+ * The type of TL_TAG_EXEC_EP_INFO64 (or TL_TAG_EXEC_EP_INFO32 on AArch32),
+ * struct entry_point_info, is tied to it in ep_info.h of the arm project API.
+ * TL_GET() requires C11.
+ */
+
+/* Tie the payload type of entries with the given tag to the tag */
+#define TL_TAG_PAYLOAD_TYPE(tag, type) typedef type tag##_payload_t
+
+/* Payload of TL_TAG_OPTEE_PAGABLE_PART entries */
+struct transfer_list_optee_pageable_part {
+	uint64_t pp_addr;
+};
+
+/* Payload of TL_TAG_SRAM_LAYOUT64 entries */
+struct transfer_list_sram_layout64 {
+	uint64_t addr;
+	uint64_t size;
+};
+
+/* Payload of TL_TAG_MBEDTLS_HEAP_INFO entries */
+struct __attribute__((packed)) transfer_list_mbedtls_heap_info {
+	uint64_t heap_addr;
+	uint32_t heap_size;
+};
+
+/* Payload of TL_TAG_SRAM_LAYOUT32 entries */
+struct transfer_list_sram_layout32 {
+	uint32_t addr;
+	uint32_t size;
+};
+
+LIBTL_STATIC_ASSERT(sizeof(struct transfer_list_optee_pageable_part) == 0x8U,
+		    assert_optee_pageable_part_size);
+LIBTL_STATIC_ASSERT(sizeof(struct transfer_list_sram_layout64) == 0x10U,
+		    assert_sram_layout64_size);
+LIBTL_STATIC_ASSERT(sizeof(struct transfer_list_mbedtls_heap_info) == 0xcU,
+		    assert_mbedtls_heap_info_size);
+LIBTL_STATIC_ASSERT(sizeof(struct transfer_list_sram_layout32) == 0x8U,
+		    assert_sram_layout32_size);
+
+TL_TAG_PAYLOAD_TYPE(TL_TAG_OPTEE_PAGABLE_PART,
+		    struct transfer_list_optee_pageable_part);
+TL_TAG_PAYLOAD_TYPE(TL_TAG_SRAM_LAYOUT64, struct transfer_list_sram_layout64);
+TL_TAG_PAYLOAD_TYPE(TL_TAG_MBEDTLS_HEAP_INFO,
+		    struct transfer_list_mbedtls_heap_info);
+TL_TAG_PAYLOAD_TYPE(TL_TAG_SRAM_LAYOUT32, struct transfer_list_sram_layout32);
+
+/**
+ * Find the first entry with a tag and check that its data can hold an object
+ * of the given size and alignment. Used by TL_GET().
+ *
+ * @param[in] tl      Pointer to the transfer list.
+ * @param[in] tag_id  Tag identifier to search for.
+ * @param[in] size    Minimum data size of the entry.
+ * @param[in] align   Required alignment of the data, a power of two.
+ *
+ * @return Pointer to the entry data, or NULL if there is no entry with the
+ *         tag or its data is too small or misaligned.
+ */
+static inline void *
+transfer_list_get_payload(struct transfer_list_header *tl, uint32_t tag_id,
+			  size_t size, size_t align)
+{
+	struct transfer_list_entry *te = transfer_list_find(tl, tag_id);
+	void *data;
+
+	if (te == NULL || te->data_size < size) {
+		return NULL;
+	}
+
+	data = transfer_list_entry_data(te);
+	if (((uintptr_t)data & (align - 1U)) != 0U) {
+		return NULL;
+	}
+
+	return data;
+}
+
+#if __STDC_VERSION__ >= 201112L
+/*
+ * Get a typed pointer to the payload of the first entry with the given tag,
+ * or NULL if there is none or its data is too small or misaligned for type.
+ * Fails to compile if type is not the payload type tied to the tag.
+ */
+#define TL_GET(tl, tag, type)                                       \
+	((type *)_Generic((type *)NULL,                             \
+		tag##_payload_t *: transfer_list_get_payload)(      \
+		(tl), (tag), sizeof(type), _Alignof(type)))
+#endif
+
+#endif /* TRANSFER_LIST_TYPED_H */
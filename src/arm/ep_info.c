@@ -15,7 +15,21 @@ transfer_list_set_handoff_args(struct transfer_list_header *tl,
 	struct transfer_list_entry *te = NULL;
 	void *dt = NULL;
 
-	if (!ep_info || !tl || transfer_list_check_header(tl) == TL_OPS_NON) {
+	if (!ep_info || !tl) {
+		return NULL;
+	}
+
+	/* a list still being built must not be handed over */
+	if (tl->flags & (TL_FLAGS_LIBTL_RESERVED | TL_FLAGS_LIBTL_BATCH)) {
+		return NULL;
+	}
+
+	/* account for entry data written in place, clearing the dirty flag */
+	if (tl->flags & TL_FLAGS_LIBTL_DIRTY) {
+		transfer_list_update_checksum(tl);
+	}
+
+	if (transfer_list_check_header(tl) == TL_OPS_NON) {
 		return NULL;
 	}
 
@@ -0,0 +1,185 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#include <string.h>
+
+#include <private/checksum.h>
+#include <private/stats.h>
+
+#if defined(LIBTL_CHECKSUM_AVX2)
+#include <immintrin.h>
+#elif defined(LIBTL_CHECKSUM_SSE2)
+#include <emmintrin.h>
+#elif defined(LIBTL_CHECKSUM_NEON)
+#include <arm_neon.h>
+#endif
+
+/* bytes copied before summing them, small enough to stay in the L1 cache */
+#define COPY_SUM_CHUNK 1024U
+
+#define BYTE_LANES_LO 0x7f7f7f7f7f7f7f7fULL
+#define BYTE_LANES_HI 0x8080808080808080ULL
+
+static uint8_t byte_sum_bytewise(const uint8_t *b, size_t size)
+{
+	uint8_t cs = 0;
+	size_t n = 0;
+
+	for (n = 0; n < size; n++) {
+		cs += b[n];
+	}
+
+	return cs;
+}
+
+#if !defined(LIBTL_CHECKSUM_BYTE)
+/*
+ * Add the eight bytes of two words lane by lane, modulo 256, without letting
+ * carries cross into the neighbouring byte.
+ */
+static inline uint64_t swar_add_bytes(uint64_t a, uint64_t b)
+{
+	return ((a & BYTE_LANES_LO) + (b & BYTE_LANES_LO)) ^
+	       ((a ^ b) & BYTE_LANES_HI);
+}
+
+static inline uint8_t swar_fold(uint64_t acc)
+{
+	uint8_t cs = 0;
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		cs += (uint8_t)(acc >> (i * 8));
+	}
+
+	return cs;
+}
+
+/*
+ * Word-at-a-time byte sum: since only the sum modulo 256 is of interest, every
+ * byte lane of a 64-bit accumulator is allowed to wrap independently. The
+ * lanes are folded into a single byte at the end.
+ */
+static uint8_t byte_sum_words(const uint8_t *b, size_t size)
+{
+	uint64_t acc = 0;
+	uint64_t w;
+	size_t n = 0;
+
+	for (; n + sizeof(w) <= size; n += sizeof(w)) {
+		memcpy(&w, b + n, sizeof(w));
+		acc = swar_add_bytes(acc, w);
+	}
+
+	return swar_fold(acc) + byte_sum_bytewise(b + n, size - n);
+}
+#endif
+
+#if defined(LIBTL_CHECKSUM_AVX2)
+static uint8_t byte_sum_vector(const uint8_t *b, size_t size)
+{
+	__m256i acc = _mm256_setzero_si256();
+	__m128i sum;
+	size_t n = 0;
+
+	for (; n + sizeof(acc) <= size; n += sizeof(acc)) {
+		acc = _mm256_add_epi8(
+			acc, _mm256_loadu_si256((const __m256i *)(b + n)));
+	}
+
+	/* horizontal sum of the 32 byte lanes via SAD against zero */
+	acc = _mm256_sad_epu8(acc, _mm256_setzero_si256());
+	sum = _mm_add_epi64(_mm256_castsi256_si128(acc),
+			    _mm256_extracti128_si256(acc, 1));
+	sum = _mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum));
+
+	return (uint8_t)_mm_cvtsi128_si32(sum) +
+	       byte_sum_words(b + n, size - n);
+}
+#elif defined(LIBTL_CHECKSUM_SSE2)
+static uint8_t byte_sum_vector(const uint8_t *b, size_t size)
+{
+	__m128i acc = _mm_setzero_si128();
+	size_t n = 0;
+
+	for (; n + sizeof(acc) <= size; n += sizeof(acc)) {
+		acc = _mm_add_epi8(acc,
+				   _mm_loadu_si128((const __m128i *)(b + n)));
+	}
+
+	/* horizontal sum of the 16 byte lanes via SAD against zero */
+	acc = _mm_sad_epu8(acc, _mm_setzero_si128());
+	acc = _mm_add_epi64(acc, _mm_unpackhi_epi64(acc, acc));
+
+	return (uint8_t)_mm_cvtsi128_si32(acc) +
+	       byte_sum_words(b + n, size - n);
+}
+#elif defined(LIBTL_CHECKSUM_NEON)
+static uint8_t byte_sum_vector(const uint8_t *b, size_t size)
+{
+	uint8x16_t acc = vdupq_n_u8(0);
+	size_t n = 0;
+
+	for (; n + sizeof(acc) <= size; n += sizeof(acc)) {
+		acc = vaddq_u8(acc, vld1q_u8(b + n));
+	}
+
+	/* horizontal add across the 16 byte lanes, wrapping modulo 256 */
+	return vaddvq_u8(acc) + byte_sum_words(b + n, size - n);
+}
+#endif
+
+uint8_t libtl_byte_sum(const void *addr, size_t size)
+{
+	libtl_stat_add(bytes_summed, size);
+
+#if defined(LIBTL_CHECKSUM_BYTE)
+	return byte_sum_bytewise(addr, size);
+#elif defined(LIBTL_CHECKSUM_AVX2) || defined(LIBTL_CHECKSUM_SSE2) || \
+	defined(LIBTL_CHECKSUM_NEON)
+	return byte_sum_vector(addr, size);
+#else
+	return byte_sum_words(addr, size);
+#endif
+}
+
+/*
+ * Copy the region in chunks and sum every chunk right after it was written,
+ * while it is still in the cache, so that the data is only read from memory
+ * once. Overlapping regions are copied front to back or back to front,
+ * whichever does not overwrite source bytes before they were copied.
+ */
+uint8_t libtl_copy_sum(void *dst, const void *src, size_t size)
+{
+	uint8_t *d = dst;
+	const uint8_t *s = src;
+	size_t n, chunk;
+	uint8_t cs = 0;
+
+	libtl_stat_add(bytes_moved, size);
+
+	if (d <= s || d >= s + size) {
+		for (n = 0; n < size; n += chunk) {
+			chunk = size - n;
+			if (chunk > COPY_SUM_CHUNK) {
+				chunk = COPY_SUM_CHUNK;
+			}
+			memmove(d + n, s + n, chunk);
+			cs += libtl_byte_sum(d + n, chunk);
+		}
+	} else {
+		for (n = size; n > 0; n -= chunk) {
+			chunk = n;
+			if (chunk > COPY_SUM_CHUNK) {
+				chunk = COPY_SUM_CHUNK;
+			}
+			memmove(d + n - chunk, s + n - chunk, chunk);
+			cs += libtl_byte_sum(d + n - chunk, chunk);
+		}
+	}
+
+	return cs;
+}
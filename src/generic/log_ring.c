@@ -0,0 +1,508 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <log_ring.h>
+
+/* records are kept 8-byte aligned so that their arguments can be read */
+#define RECORD_ALIGN 8U
+
+/* maximum length of a formatted message, including the terminator */
+#define MSG_MAX 256U
+
+/* maximum length of a single conversion specification */
+#define SPEC_MAX 32U
+
+enum log_ring_level { LEVEL_INFO, LEVEL_WARN, LEVEL_ERROR };
+
+static const char *const level_names[] = { "INFO", "WARN", "ERROR" };
+
+/*
+ * How the argument of a conversion specification has to be fetched from a
+ * va_list, and later passed to snprintf() again
+ */
+enum arg_kind {
+	ARG_NONE, /* no argument, e.g. %% */
+	ARG_INT,
+	ARG_LONG,
+	ARG_LLONG,
+	ARG_UINT,
+	ARG_ULONG,
+	ARG_ULLONG,
+	ARG_SIZE,
+	ARG_PTRDIFF,
+	ARG_INTMAX,
+	ARG_UINTMAX,
+	ARG_PTR,
+	ARG_STR,
+	ARG_UNSUPPORTED, /* e.g. floating point, stops argument recording */
+};
+
+struct spec {
+	const char *start; /* the '%' character */
+	size_t len; /* length including '%' and the conversion */
+	unsigned int stars; /* number of '*' width or precision arguments */
+	enum arg_kind kind;
+};
+
+struct record {
+	uint16_t size; /* record size in bytes, 0 marks a wrap to the start */
+	uint8_t level;
+	uint8_t nargs;
+	uint32_t reserved;
+	uint64_t timestamp;
+	const char *fmt;
+	uint64_t args[]; /* raw values, or record offsets of copied strings */
+};
+
+/* Ring the registered logger records into */
+static struct libtl_log_ring *active_ring;
+
+/*******************************************************************************
+ * Parse the conversion specification starting at the '%' character at p.
+ * Return pointer to the character following it.
+ ******************************************************************************/
+static const char *parse_spec(const char *p, struct spec *sp)
+{
+	const char *s = p + 1;
+	int len_mod = 0; /* 'H' for hh, 'h', 'l', 'L' for ll, 'j', 'z', 't' */
+	int i;
+
+	sp->start = p;
+	sp->stars = 0;
+
+	while (*s && strchr("-+ #0", *s)) {
+		s++;
+	}
+
+	/* width, then precision */
+	for (i = 0; i < 2; i++) {
+		if (i == 1) {
+			if (*s != '.') {
+				break;
+			}
+			s++;
+		}
+		if (*s == '*') {
+			sp->stars++;
+			s++;
+		} else {
+			while (*s >= '0' && *s <= '9') {
+				s++;
+			}
+		}
+	}
+
+	if (*s == 'h' || *s == 'l') {
+		len_mod = *s++;
+		if (*s == len_mod) {
+			len_mod = (len_mod == 'h') ? 'H' : 'L';
+			s++;
+		}
+	} else if (*s == 'j' || *s == 'z' || *s == 't') {
+		len_mod = *s++;
+	}
+
+	switch (*s) {
+	case '%':
+		sp->kind = ARG_NONE;
+		break;
+	case 'd':
+	case 'i':
+	case 'c':
+		sp->kind = (len_mod == 'l') ? ARG_LONG :
+			   (len_mod == 'L') ? ARG_LLONG :
+			   (len_mod == 'j') ? ARG_INTMAX :
+			   (len_mod == 'z') ? ARG_SIZE :
+			   (len_mod == 't') ? ARG_PTRDIFF :
+					      ARG_INT;
+		break;
+	case 'u':
+	case 'x':
+	case 'X':
+	case 'o':
+		sp->kind = (len_mod == 'l') ? ARG_ULONG :
+			   (len_mod == 'L') ? ARG_ULLONG :
+			   (len_mod == 'j') ? ARG_UINTMAX :
+			   (len_mod == 'z') ? ARG_SIZE :
+			   (len_mod == 't') ? ARG_PTRDIFF :
+					      ARG_UINT;
+		break;
+	case 'p':
+		sp->kind = ARG_PTR;
+		break;
+	case 's':
+		sp->kind = ARG_STR;
+		break;
+	default:
+		sp->kind = ARG_UNSUPPORTED;
+		break;
+	}
+
+	if (*s) {
+		s++;
+	}
+	sp->len = s - p;
+
+	return s;
+}
+
+static uint64_t fetch_arg(enum arg_kind kind, va_list *args)
+{
+	switch (kind) {
+	case ARG_INT:
+		return (uint64_t)(int64_t)va_arg(*args, int);
+	case ARG_LONG:
+		return (uint64_t)(int64_t)va_arg(*args, long);
+	case ARG_LLONG:
+		return (uint64_t)va_arg(*args, long long);
+	case ARG_UINT:
+		return va_arg(*args, unsigned int);
+	case ARG_ULONG:
+		return va_arg(*args, unsigned long);
+	case ARG_ULLONG:
+		return va_arg(*args, unsigned long long);
+	case ARG_SIZE:
+		return va_arg(*args, size_t);
+	case ARG_PTRDIFF:
+		return (uint64_t)(int64_t)va_arg(*args, ptrdiff_t);
+	case ARG_INTMAX:
+		return (uint64_t)va_arg(*args, intmax_t);
+	case ARG_UINTMAX:
+		return (uint64_t)va_arg(*args, uintmax_t);
+	case ARG_PTR:
+	case ARG_STR:
+		return (uintptr_t)va_arg(*args, void *);
+	default:
+		return 0;
+	}
+}
+
+/*******************************************************************************
+ * Find room for a record of the given size, which must be a multiple of
+ * RECORD_ALIGN. The ring never fills up completely, so that head == tail
+ * always means it is empty.
+ * Return pointer to the room or NULL if the record does not fit.
+ ******************************************************************************/
+static struct record *ring_reserve(struct libtl_log_ring *ring, size_t size)
+{
+	struct record *rec;
+
+	/* an empty ring starts over, so that a record can use all of it */
+	if (ring->head == ring->tail) {
+		ring->head = 0;
+		ring->tail = 0;
+	}
+
+	if (ring->head >= ring->tail) {
+		if (ring->head + size < ring->size ||
+		    (ring->head + size == ring->size && ring->tail != 0)) {
+			rec = (struct record *)(ring->buf + ring->head);
+		} else if (size < ring->tail) {
+			/* mark the rest of the buffer as unused */
+			rec = (struct record *)(ring->buf + ring->head);
+			rec->size = 0;
+			ring->head = 0;
+			rec = (struct record *)ring->buf;
+		} else {
+			return NULL;
+		}
+	} else if (ring->head + size < ring->tail) {
+		rec = (struct record *)(ring->buf + ring->head);
+	} else {
+		return NULL;
+	}
+
+	ring->head += size;
+	if (ring->head == ring->size) {
+		ring->head = 0;
+	}
+
+	return rec;
+}
+
+static void ring_record(enum log_ring_level level, const char *fmt,
+			va_list args)
+{
+	struct libtl_log_ring *ring = active_ring;
+	const char *strs[LIBTL_LOG_RING_MAX_ARGS];
+	uint64_t vals[LIBTL_LOG_RING_MAX_ARGS];
+	size_t str_len[LIBTL_LOG_RING_MAX_ARGS];
+	size_t size, off, i, n = 0;
+	struct record *rec;
+	struct spec sp;
+	const char *p = fmt;
+	va_list ap;
+
+	if (ring == NULL || fmt == NULL) {
+		return;
+	}
+
+	va_copy(ap, args);
+	size = sizeof(*rec);
+	while ((p = strchr(p, '%')) != NULL) {
+		p = parse_spec(p, &sp);
+		if (sp.kind == ARG_UNSUPPORTED || sp.len >= SPEC_MAX ||
+		    n + sp.stars + 1 > LIBTL_LOG_RING_MAX_ARGS) {
+			break;
+		}
+		for (i = 0; i < sp.stars; i++) {
+			strs[n] = NULL;
+			vals[n++] = fetch_arg(ARG_INT, &ap);
+		}
+		if (sp.kind == ARG_NONE) {
+			continue;
+		}
+
+		strs[n] = NULL;
+		vals[n] = fetch_arg(sp.kind, &ap);
+		if (sp.kind == ARG_STR && vals[n] != 0) {
+			strs[n] = (const char *)(uintptr_t)vals[n];
+			str_len[n] = strnlen(strs[n], LIBTL_LOG_RING_MAX_STR);
+			size += str_len[n] + 1;
+		}
+		n++;
+	}
+	va_end(ap);
+
+	size += n * sizeof(rec->args[0]);
+	size = (size + RECORD_ALIGN - 1) & ~(size_t)(RECORD_ALIGN - 1);
+
+	rec = ring_reserve(ring, size);
+	if (rec == NULL) {
+		ring->dropped++;
+		return;
+	}
+
+	rec->size = size;
+	rec->level = level;
+	rec->nargs = n;
+	rec->reserved = 0;
+	rec->timestamp = ring->timestamp ? ring->timestamp() : 0;
+	rec->fmt = fmt;
+
+	off = sizeof(*rec) + n * sizeof(rec->args[0]);
+	for (i = 0; i < n; i++) {
+		rec->args[i] = vals[i];
+		if (strs[i] != NULL) {
+			memcpy((uint8_t *)rec + off, strs[i], str_len[i]);
+			((char *)rec)[off + str_len[i]] = '\0';
+			rec->args[i] = off;
+			off += str_len[i] + 1;
+		}
+	}
+}
+
+/*******************************************************************************
+ * Format one conversion specification with its recorded argument.
+ * Return the number of characters snprintf() wanted to write.
+ ******************************************************************************/
+static int format_arg(char *out, size_t out_size, const char *spec,
+		      enum arg_kind kind, uint64_t val,
+		      const struct record *rec)
+{
+	switch (kind) {
+	case ARG_INT:
+		return snprintf(out, out_size, spec, (int)val);
+	case ARG_LONG:
+		return snprintf(out, out_size, spec, (long)val);
+	case ARG_LLONG:
+		return snprintf(out, out_size, spec, (long long)val);
+	case ARG_UINT:
+		return snprintf(out, out_size, spec, (unsigned int)val);
+	case ARG_ULONG:
+		return snprintf(out, out_size, spec, (unsigned long)val);
+	case ARG_ULLONG:
+		return snprintf(out, out_size, spec, (unsigned long long)val);
+	case ARG_SIZE:
+		return snprintf(out, out_size, spec, (size_t)val);
+	case ARG_PTRDIFF:
+		return snprintf(out, out_size, spec, (ptrdiff_t)val);
+	case ARG_INTMAX:
+		return snprintf(out, out_size, spec, (intmax_t)val);
+	case ARG_UINTMAX:
+		return snprintf(out, out_size, spec, (uintmax_t)val);
+	case ARG_PTR:
+		return snprintf(out, out_size, spec, (void *)(uintptr_t)val);
+	case ARG_STR:
+		return snprintf(out, out_size, spec,
+				val ? (const char *)rec + val : "(null)");
+	default:
+		return 0;
+	}
+}
+
+static void format_record(const struct record *rec, char *msg, size_t size)
+{
+	const char *p = rec->fmt, *next;
+	char spec[SPEC_MAX + 2 * sizeof("-2147483648")];
+	size_t pos = 0, n = 0, len, i;
+	struct spec sp;
+	int ret;
+
+	while (*p && pos + 1 < size) {
+		next = strchr(p, '%');
+		len = next ? (size_t)(next - p) : strlen(p);
+		if (len > 0) {
+			if (len > size - 1 - pos) {
+				len = size - 1 - pos;
+			}
+			memcpy(msg + pos, p, len);
+			pos += len;
+			p += len;
+			continue;
+		}
+
+		next = parse_spec(p, &sp);
+		if (sp.kind == ARG_NONE && sp.stars == 0) {
+			msg[pos++] = '%';
+		} else if (sp.kind == ARG_UNSUPPORTED || sp.len >= SPEC_MAX ||
+			   n + sp.stars + 1 > rec->nargs) {
+			/* not recorded, print the specification as it is */
+			len = sp.len;
+			if (len > size - 1 - pos) {
+				len = size - 1 - pos;
+			}
+			memcpy(msg + pos, p, len);
+			pos += len;
+		} else {
+			/* substitute recorded '*' arguments into the spec */
+			len = 0;
+			for (i = 0; i < sp.len; i++) {
+				if (p[i] != '*') {
+					spec[len++] = p[i];
+					continue;
+				}
+				len += snprintf(spec + len, sizeof(spec) - len,
+						"%d", (int)rec->args[n++]);
+			}
+			spec[len] = '\0';
+
+			ret = format_arg(msg + pos, size - pos, spec, sp.kind,
+					 rec->args[n], rec);
+			if (sp.kind != ARG_NONE) {
+				n++;
+			}
+			if (ret > 0 && (size_t)ret >= size - pos) {
+				ret = size - 1 - pos;
+			}
+			if (ret > 0) {
+				pos += ret;
+			}
+		}
+		p = next;
+	}
+
+	msg[pos] = '\0';
+}
+
+static void ring_info(const char *fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	ring_record(LEVEL_INFO, fmt, args);
+	va_end(args);
+}
+
+static void ring_warn(const char *fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	ring_record(LEVEL_WARN, fmt, args);
+	va_end(args);
+}
+
+static void ring_error(const char *fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	ring_record(LEVEL_ERROR, fmt, args);
+	va_end(args);
+}
+
+static struct logger_interface ring_logger = {
+	.info = ring_info,
+	.warn = ring_warn,
+	.error = ring_error,
+};
+
+bool libtl_log_ring_init(struct libtl_log_ring *ring, void *buf, size_t size,
+			 uint64_t (*timestamp)(void))
+{
+	uintptr_t start, end;
+
+	if (ring == NULL || buf == NULL) {
+		return false;
+	}
+
+	start = ((uintptr_t)buf + RECORD_ALIGN - 1) &
+		~(uintptr_t)(RECORD_ALIGN - 1);
+	end = ((uintptr_t)buf + size) & ~(uintptr_t)(RECORD_ALIGN - 1);
+	if (end <= start || end - start <= sizeof(struct record)) {
+		return false;
+	}
+
+	ring->buf = (uint8_t *)start;
+	ring->size = end - start;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->dropped = 0;
+	ring->timestamp = timestamp;
+
+	return true;
+}
+
+void libtl_log_ring_register(struct libtl_log_ring *ring)
+{
+	active_ring = ring;
+	libtl_register_logger(&ring_logger);
+}
+
+size_t libtl_log_ring_drain(struct libtl_log_ring *ring,
+			    void (*emit)(const char *level, uint64_t timestamp,
+					 const char *msg))
+{
+	const struct record *rec;
+	char msg[MSG_MAX];
+	size_t n = 0;
+
+	if (ring == NULL || emit == NULL) {
+		return 0;
+	}
+
+	while (ring->tail != ring->head) {
+		rec = (const struct record *)(ring->buf + ring->tail);
+		if (rec->size == 0) {
+			ring->tail = 0;
+			continue;
+		}
+
+		format_record(rec, msg, sizeof(msg));
+		emit(level_names[rec->level], rec->timestamp, msg);
+		n++;
+
+		ring->tail += rec->size;
+		if (ring->tail == ring->size) {
+			ring->tail = 0;
+		}
+	}
+
+	if (ring->dropped != 0U) {
+		snprintf(msg, sizeof(msg), "%u log messages dropped\n",
+			 (unsigned int)ring->dropped);
+		ring->dropped = 0;
+		emit(level_names[LEVEL_WARN],
+		     ring->timestamp ? ring->timestamp() : 0, msg);
+		n++;
+	}
+
+	return n;
+}
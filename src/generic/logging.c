@@ -47,6 +47,7 @@ void libtl_register_logger(struct logger_interface *user_logger)
 {
 	if (user_logger != NULL) {
 		logger = user_logger;
+		return;
 	}
 
 	_logger.info = libtl_info;
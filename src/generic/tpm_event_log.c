@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <inttypes.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -28,8 +29,8 @@ uint8_t *transfer_list_event_log_extend(struct transfer_list_header *tl,
 
 		if (transfer_list_set_data_size(tl, existing_entry,
 						req_size + existing_offset)) {
-			info("TPM event log entry resized: new space %zu bytes at offset %zu\n",
-			     req_size, existing_offset);
+			verbose("TPM event log entry resized: new space %zu bytes at offset %zu\n",
+				req_size, existing_offset);
 
 			return transfer_list_entry_data(existing_entry) +
 			       existing_offset;
@@ -48,8 +49,8 @@ uint8_t *transfer_list_event_log_extend(struct transfer_list_header *tl,
 	new_data_ptr = transfer_list_entry_data(new_entry);
 
 	if (existing_entry != NULL) {
-		info("Copying existing event log (%zu bytes) to new entry at %p\n",
-		     existing_offset, new_data_ptr);
+		verbose("Copying existing event log (%zu bytes) to new entry at %p\n",
+			existing_offset, new_data_ptr);
 
 		memmove(new_data_ptr, transfer_list_entry_data(existing_entry),
 			existing_offset);
@@ -85,8 +86,132 @@ uint8_t *transfer_list_event_log_finish(struct transfer_list_header *tl,
 
 	transfer_list_update_checksum(tl);
 
-	info("TPM event log finalized: trimmed to %zu bytes",
-	     final_log_size - EVENT_LOG_RESERVED_BYTES);
+	verbose("TPM event log finalized: trimmed to %zu bytes",
+		final_log_size - EVENT_LOG_RESERVED_BYTES);
 
 	return (uint8_t *)(entry_data_base + EVENT_LOG_RESERVED_BYTES);
 }
+
+/*******************************************************************************
+ * Resize the event log TE to the given capacity, moving it to the end of the
+ * list if it cannot grow in place.
+ * Return true on success.
+ ******************************************************************************/
+static bool event_log_writer_resize(struct transfer_list_event_log_writer *w,
+				    size_t capacity)
+{
+	struct transfer_list_entry *te;
+
+	if (capacity > UINT32_MAX) {
+		return false;
+	}
+
+	if (w->te != NULL &&
+	    transfer_list_set_data_size(w->tl, w->te, capacity)) {
+		return true;
+	}
+
+	te = transfer_list_add(w->tl, TL_TAG_TPM_EVLOG, capacity, NULL);
+	if (te == NULL) {
+		return false;
+	}
+
+	if (w->te != NULL) {
+		memmove(transfer_list_entry_data(te),
+			transfer_list_entry_data(w->te), w->cursor);
+		transfer_list_rem(w->tl, w->te);
+	}
+	w->te = te;
+
+	return true;
+}
+
+bool transfer_list_event_log_writer_init(
+	struct transfer_list_event_log_writer *writer,
+	struct transfer_list_header *tl)
+{
+	if (writer == NULL || tl == NULL) {
+		return false;
+	}
+
+	writer->tl = tl;
+	writer->te = transfer_list_find(tl, TL_TAG_TPM_EVLOG);
+	writer->cursor = EVENT_LOG_RESERVED_BYTES;
+	if (writer->te != NULL) {
+		writer->cursor = writer->te->data_size;
+	}
+
+	return true;
+}
+
+uint8_t *transfer_list_event_log_writer_extend(
+	struct transfer_list_event_log_writer *writer, size_t req_size)
+{
+	size_t needed, capacity = 0;
+	uint8_t *ptr;
+
+	if (writer == NULL || writer->tl == NULL || req_size == 0U ||
+	    req_size > UINT32_MAX - writer->cursor) {
+		error("Invalid arguments to event log extend.\n");
+		return NULL;
+	}
+
+	needed = writer->cursor + req_size;
+	if (writer->te != NULL) {
+		capacity = writer->te->data_size;
+	}
+
+	if (needed > capacity) {
+		/* double the capacity, or settle for what is needed */
+		capacity *= 2;
+		if (capacity < EVENT_LOG_WRITER_MIN_CAPACITY) {
+			capacity = EVENT_LOG_WRITER_MIN_CAPACITY;
+		}
+		if (capacity < needed) {
+			capacity = needed;
+		}
+
+		if (!event_log_writer_resize(writer, capacity) &&
+		    !event_log_writer_resize(writer, needed)) {
+			error("Failed to grow TPM event log entry.\n");
+			return NULL;
+		}
+
+		verbose("TPM event log capacity grown to %" PRIu32 " bytes\n",
+			writer->te->data_size);
+	}
+
+	ptr = (uint8_t *)transfer_list_entry_data(writer->te) + writer->cursor;
+	writer->cursor = needed;
+
+	return ptr;
+}
+
+uint8_t *transfer_list_event_log_writer_finish(
+	struct transfer_list_event_log_writer *writer)
+{
+	uint8_t *log = NULL;
+
+	if (writer == NULL || writer->tl == NULL) {
+		return NULL;
+	}
+
+	if (writer->te != NULL) {
+		/*
+		 * Shrinking an entry always succeeds, and takes the events
+		 * logged since the last growth into the checksum.
+		 */
+		transfer_list_set_data_size(writer->tl, writer->te,
+					    writer->cursor);
+		log = (uint8_t *)transfer_list_entry_data(writer->te) +
+		      EVENT_LOG_RESERVED_BYTES;
+
+		verbose("TPM event log finalized: trimmed to %zu bytes\n",
+			writer->cursor - EVENT_LOG_RESERVED_BYTES);
+	}
+
+	writer->tl = NULL;
+	writer->te = NULL;
+
+	return log;
+}
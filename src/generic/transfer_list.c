@@ -10,9 +10,375 @@
 #include <string.h>
 
 #include <logging.h>
+#include <private/checksum.h>
 #include <private/math_utils.h>
+#include <private/stats.h>
+#include <private/validate.h>
 #include <transfer_list.h>
 
+#if defined(LIBTL_STATS)
+struct transfer_list_stats libtl_stats;
+#endif
+
+/*******************************************************************************
+ * memmove() that accounts for the moved bytes in the statistics
+ ******************************************************************************/
+static inline void *counted_memmove(void *dst, const void *src, size_t size)
+{
+	libtl_stat_add(bytes_moved, size);
+	return memmove(dst, src, size);
+}
+
+/*******************************************************************************
+ * Incremental checksum maintenance
+ *
+ * The checksum is kept such that the byte sum of [tl, tl + tl->size) is zero.
+ * Before a region inside the list is modified, its contribution is taken out
+ * of the checksum with checksum_remove(); once the region holds its new
+ * contents (or has newly become part of the list), checksum_add() accounts for
+ * it again. A mutation therefore only costs the bytes it touches. Neither
+ * region may contain the checksum byte itself.
+ *
+ * Inside a batch session, marked by TL_FLAGS_LIBTL_BATCH, the checksum is left
+ * alone altogether and recomputed once by transfer_list_batch_commit().
+ *
+ * Entry data that the caller fills in after the call that made room for it,
+ * i.e. entries added without data and grown entries, is not seen by the
+ * incremental updates. Such calls mark the list with TL_FLAGS_LIBTL_DIRTY and
+ * the next call that modifies the list recomputes the checksum once before
+ * making its own changes.
+ ******************************************************************************/
+static void checksum_remove(struct transfer_list_header *tl, const void *addr,
+			    size_t size)
+{
+	if ((tl->flags & (TL_FLAGS_HAS_CHECKSUM | TL_FLAGS_LIBTL_BATCH)) ==
+	    TL_FLAGS_HAS_CHECKSUM) {
+		tl->checksum += libtl_byte_sum(addr, size);
+	}
+}
+
+static void checksum_add(struct transfer_list_header *tl, const void *addr,
+			 size_t size)
+{
+	if ((tl->flags & (TL_FLAGS_HAS_CHECKSUM | TL_FLAGS_LIBTL_BATCH)) ==
+	    TL_FLAGS_HAS_CHECKSUM) {
+		tl->checksum -= libtl_byte_sum(addr, size);
+	}
+}
+
+/*
+ * Note that the caller may write entry data behind the library's back. A list
+ * without a checksum, or one in a batch session whose checksum is recomputed
+ * on commit anyway, has nothing to resync.
+ */
+static void checksum_mark_dirty(struct transfer_list_header *tl)
+{
+	if ((tl->flags & (TL_FLAGS_HAS_CHECKSUM | TL_FLAGS_LIBTL_BATCH |
+			  TL_FLAGS_LIBTL_DIRTY)) != TL_FLAGS_HAS_CHECKSUM) {
+		return;
+	}
+
+	checksum_remove(tl, &tl->flags, sizeof(tl->flags));
+	tl->flags |= TL_FLAGS_LIBTL_DIRTY;
+	checksum_add(tl, &tl->flags, sizeof(tl->flags));
+}
+
+/*
+ * Bring the checksum of a list marked dirty up to date before it is changed
+ * incrementally. A reserved entry is not part of the checksum yet, so the
+ * recomputation is left to transfer_list_commit() then.
+ */
+static void checksum_sync(struct transfer_list_header *tl)
+{
+	if ((tl->flags & TL_FLAGS_LIBTL_DIRTY) &&
+	    !(tl->flags & (TL_FLAGS_LIBTL_BATCH | TL_FLAGS_LIBTL_RESERVED))) {
+		transfer_list_update_checksum(tl);
+	}
+}
+
+/*
+ * Debug builds cross-check the incrementally maintained checksum against a
+ * full rescan once a call is done with the list. A list that may hold data
+ * the caller is still filling in, or that is in a batch session, is not
+ * expected to sum up.
+ */
+static void checksum_check(const struct transfer_list_header *tl)
+{
+	(void)tl;
+	assert((tl->flags & TL_FLAGS_HAS_CHECKSUM) == 0U ||
+	       (tl->flags & (TL_FLAGS_LIBTL_DIRTY | TL_FLAGS_LIBTL_BATCH |
+			     TL_FLAGS_LIBTL_RESERVED)) ||
+	       libtl_byte_sum(tl, tl->size) == 0U);
+}
+
+/*******************************************************************************
+ * Tag index maintenance
+ *
+ * When the first TE of a list is a TL_TAG_LIBTL_INDEX entry, its data holds a
+ * table of (tag_id, offset) records for every other non-empty TE, sorted by
+ * tag_id and then by offset. The index is only trusted while its tl_size field
+ * matches tl->size; anything that changes the list layout behind the library's
+ * back, or an index that ran out of capacity, leaves it stale and lookups fall
+ * back to walking the list.
+ ******************************************************************************/
+static struct transfer_list_entry *index_te(struct transfer_list_header *tl)
+{
+	struct transfer_list_entry *te = transfer_list_next(tl, NULL);
+
+	if (!te || te->tag_id != TL_TAG_LIBTL_INDEX ||
+	    te->data_size < sizeof(struct transfer_list_index)) {
+		return NULL;
+	}
+
+	return te;
+}
+
+static uint32_t index_capacity(struct transfer_list_entry *te)
+{
+	return (te->data_size - sizeof(struct transfer_list_index)) /
+	       sizeof(struct transfer_list_index_entry);
+}
+
+/*
+ * Return the index of a list if it is present and up to date, NULL otherwise
+ */
+static struct transfer_list_index *index_get(struct transfer_list_header *tl)
+{
+	struct transfer_list_entry *te = index_te(tl);
+	struct transfer_list_index *idx;
+
+	if (!te) {
+		return NULL;
+	}
+
+	idx = transfer_list_entry_data(te);
+	if (idx->tl_size != tl->size || idx->count > index_capacity(te)) {
+		return NULL;
+	}
+
+	return idx;
+}
+
+static bool index_is_indexed(uint32_t tag_id)
+{
+	return tag_id != TL_TAG_EMPTY && tag_id != TL_TAG_LIBTL_INDEX;
+}
+
+/*
+ * Find the first record not ordered before (tag_id, offset)
+ */
+static uint32_t index_lower_bound(const struct transfer_list_index *idx,
+				  uint32_t tag_id, uint32_t offset)
+{
+	const struct transfer_list_index_entry *e = idx->entries;
+	uint32_t lo = 0, hi = idx->count, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (e[mid].tag_id < tag_id ||
+		    (e[mid].tag_id == tag_id && e[mid].offset < offset)) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+/*
+ * Insert a record without touching the checksum.
+ * Return false if the index is full.
+ */
+static bool index_insert_raw(struct transfer_list_index *idx, uint32_t cap,
+			     uint32_t tag_id, uint32_t offset)
+{
+	uint32_t pos;
+
+	if (idx->count >= cap) {
+		return false;
+	}
+
+	pos = index_lower_bound(idx, tag_id, offset);
+	counted_memmove(&idx->entries[pos + 1], &idx->entries[pos],
+			(idx->count - pos) * sizeof(idx->entries[0]));
+	idx->entries[pos].tag_id = tag_id;
+	idx->entries[pos].offset = offset;
+	idx->count++;
+
+	return true;
+}
+
+/*
+ * Record the new list size in an index that was up to date before the list
+ * was modified. An index that ran out of capacity is left stale instead.
+ */
+static void index_sync(struct transfer_list_header *tl,
+		       struct transfer_list_index *idx, bool stale)
+{
+	if (!idx) {
+		return;
+	}
+
+	checksum_remove(tl, &idx->tl_size, sizeof(idx->tl_size));
+	idx->tl_size = stale ? 0U : tl->size;
+	checksum_add(tl, &idx->tl_size, sizeof(idx->tl_size));
+}
+
+static void index_insert(struct transfer_list_header *tl,
+			 struct transfer_list_index *idx,
+			 struct transfer_list_entry *te)
+{
+	uint32_t offset = (uintptr_t)te - (uintptr_t)tl;
+	uint32_t cap;
+	void *start, *end;
+
+	if (!idx || !index_is_indexed(te->tag_id)) {
+		index_sync(tl, idx, false);
+		return;
+	}
+
+	cap = index_capacity(index_te(tl));
+	if (idx->count >= cap) {
+		index_sync(tl, idx, true);
+		return;
+	}
+
+	start = &idx->entries[index_lower_bound(idx, te->tag_id, offset)];
+	end = &idx->entries[idx->count + 1];
+
+	checksum_remove(tl, &idx->count, sizeof(idx->count));
+	checksum_remove(tl, start, (uintptr_t)end - (uintptr_t)start);
+	index_insert_raw(idx, cap, te->tag_id, offset);
+	checksum_add(tl, &idx->count, sizeof(idx->count));
+	checksum_add(tl, start, (uintptr_t)end - (uintptr_t)start);
+
+	index_sync(tl, idx, false);
+}
+
+static void index_remove(struct transfer_list_header *tl,
+			 struct transfer_list_index *idx,
+			 struct transfer_list_entry *te)
+{
+	uint32_t offset = (uintptr_t)te - (uintptr_t)tl;
+	uint32_t pos;
+	void *start, *end;
+
+	if (!idx || !index_is_indexed(te->tag_id)) {
+		return;
+	}
+
+	pos = index_lower_bound(idx, te->tag_id, offset);
+	if (pos == idx->count || idx->entries[pos].tag_id != te->tag_id ||
+	    idx->entries[pos].offset != offset) {
+		/* the index does not describe this list */
+		index_sync(tl, idx, true);
+		return;
+	}
+
+	start = &idx->entries[pos];
+	end = &idx->entries[idx->count];
+
+	checksum_remove(tl, &idx->count, sizeof(idx->count));
+	checksum_remove(tl, start, (uintptr_t)end - (uintptr_t)start);
+	counted_memmove(&idx->entries[pos], &idx->entries[pos + 1],
+			(idx->count - pos - 1) * sizeof(idx->entries[0]));
+	idx->count--;
+	checksum_add(tl, &idx->count, sizeof(idx->count));
+	checksum_add(tl, start, (uintptr_t)end - (uintptr_t)start);
+}
+
+/*
+ * Account for all TEs at or beyond offset having moved by dist bytes
+ */
+static void index_shift(struct transfer_list_header *tl,
+			struct transfer_list_index *idx, uint32_t offset,
+			uint32_t dist)
+{
+	uint32_t i;
+
+	if (!idx) {
+		return;
+	}
+
+	checksum_remove(tl, idx->entries, idx->count * sizeof(idx->entries[0]));
+	for (i = 0; i < idx->count; i++) {
+		if (idx->entries[i].offset >= offset) {
+			idx->entries[i].offset += dist;
+		}
+	}
+	checksum_add(tl, idx->entries, idx->count * sizeof(idx->entries[0]));
+
+	index_sync(tl, idx, false);
+}
+
+/*
+ * Rebuild the records of an index TE from the list without touching the
+ * checksum. Return false if the index is too small, leaving it stale.
+ */
+static bool index_fill(struct transfer_list_header *tl,
+		       struct transfer_list_entry *te)
+{
+	struct transfer_list_index *idx = transfer_list_entry_data(te);
+	uint32_t cap = index_capacity(te);
+	struct transfer_list_entry *it = te;
+
+	idx->count = 0;
+	idx->tl_size = 0;
+
+	while ((it = transfer_list_next(tl, it)) != NULL) {
+		if (index_is_indexed(it->tag_id) &&
+		    !index_insert_raw(idx, cap, it->tag_id,
+				      (uintptr_t)it - (uintptr_t)tl)) {
+			return false;
+		}
+	}
+
+	idx->tl_size = tl->size;
+	return true;
+}
+
+/*
+ * Look up the first TE with tag_id that comes after last (or the first one in
+ * the list if last is NULL) through the index.
+ * Return false if the index turned out to be unusable, in which case the
+ * caller has to walk the list.
+ */
+static bool index_find(struct transfer_list_header *tl,
+		       struct transfer_list_index *idx, uint32_t tag_id,
+		       struct transfer_list_entry *last,
+		       struct transfer_list_entry **res)
+{
+	struct transfer_list_entry *te;
+	uint32_t pos, offset = 0;
+
+	if (last) {
+		offset = (uint32_t)((uintptr_t)last - (uintptr_t)tl) + 1;
+	}
+	pos = index_lower_bound(idx, tag_id, offset);
+
+	*res = NULL;
+	if (pos == idx->count || idx->entries[pos].tag_id != tag_id) {
+		return true;
+	}
+
+	offset = idx->entries[pos].offset;
+	if (offset < tl->hdr_size ||
+	    !libtl_is_aligned(offset, TRANSFER_LIST_GRANULE) ||
+	    offset + sizeof(*te) > tl->size) {
+		return false;
+	}
+
+	te = (struct transfer_list_entry *)((uintptr_t)tl + offset);
+	if (te->tag_id != tag_id || te->hdr_size < sizeof(*te) ||
+	    (uint64_t)offset + te->hdr_size + te->data_size > tl->size) {
+		return false;
+	}
+
+	*res = te;
+	return true;
+}
+
 void transfer_list_dump(struct transfer_list_header *tl)
 {
 	struct transfer_list_entry *te = NULL;
@@ -56,6 +422,8 @@ struct transfer_list_header *transfer_list_init(void *addr, size_t max_size)
 {
 	struct transfer_list_header *tl = addr;
 
+	libtl_stat_call(TL_STAT_INIT);
+
 	if (!addr || max_size == 0) {
 		return NULL;
 	}
@@ -81,127 +449,452 @@ struct transfer_list_header *transfer_list_init(void *addr, size_t max_size)
 	return tl;
 }
 
+/*******************************************************************************
+ * Work out where a list relocated to addr has to start so that it keeps its
+ * alignment, and how much of the max_size bytes at addr are left from there.
+ * Return the new list address, or 0 if the region is too small to hold it.
+ ******************************************************************************/
+static uintptr_t relocate_target(struct transfer_list_header *tl, void *addr,
+				 size_t max_size, uint32_t *new_max_size)
+{
+	uintptr_t new_addr, align_mask, align_off;
+
+	align_mask = (1 << tl->alignment) - 1;
+	align_off = (uintptr_t)tl & align_mask;
+	new_addr = ((uintptr_t)addr & ~align_mask) + align_off;
+
+	if (new_addr < (uintptr_t)addr) {
+		new_addr += (1 << tl->alignment);
+	}
+
+	if (new_addr - (uintptr_t)addr >= max_size) {
+		return 0;
+	}
+
+	*new_max_size = max_size - (new_addr - (uintptr_t)addr);
+	return new_addr;
+}
+
+/*******************************************************************************
+ * Lay out the non-void TEs of tl behind the header of a list starting at dst,
+ * sliding every TE down to the lowest position that keeps its data at least
+ * as aligned as it is now, up to the list alignment. dst must have the same
+ * alignment as tl modulo the list alignment.
+ *
+ * If copy is set, the TEs are copied to their new positions, the padding up to
+ * the next granule behind each TE is cleared and alignment gaps are filled with
+ * void TEs; the byte sum of everything written is added to *sum unless sum is
+ * NULL. TEs only ever move down relative to the start of
+ * the list, so dst may overlap tl as long as it does not lie above it.
+ *
+ * Return the end address of the last TE at dst.
+ ******************************************************************************/
+static uintptr_t compact_entries(struct transfer_list_header *tl,
+				 uintptr_t dst, bool copy, uint8_t *sum)
+{
+	struct transfer_list_entry *te, *dummy_te;
+	uintptr_t src = (uintptr_t)tl;
+	uintptr_t tl_ev = src + tl->size;
+	uintptr_t max_align = 1UL << tl->alignment;
+	uintptr_t va, next, cursor, target, data_va, align, ev;
+	uint32_t hdr_size, te_size;
+
+	cursor = dst + tl->hdr_size;
+	ev = cursor;
+
+	for (va = src + tl->hdr_size; va + sizeof(*te) <= tl_ev; va = next) {
+		te = (struct transfer_list_entry *)va;
+		hdr_size = te->hdr_size;
+		if (hdr_size < sizeof(*te) ||
+		    (uint64_t)va + hdr_size + te->data_size > tl_ev) {
+			break;
+		}
+		te_size = hdr_size + te->data_size;
+		next = libtl_align_up(va + te_size, TRANSFER_LIST_GRANULE);
+
+		if (te->tag_id == TL_TAG_EMPTY) {
+			continue;
+		}
+
+		data_va = va + hdr_size;
+		align = data_va & -data_va;
+		if (align > max_align) {
+			align = max_align;
+		}
+		target = libtl_align_up(cursor + hdr_size, align) - hdr_size;
+		if (!libtl_is_aligned(target, TRANSFER_LIST_GRANULE) ||
+		    target - dst > va - src) {
+			target = dst + (va - src);
+		}
+
+		if (copy && cursor > ev) {
+			/* zeroed padding adds nothing to the sum */
+			memset((void *)ev, 0, cursor - ev);
+		}
+
+		if (copy) {
+			if (sum) {
+				*sum += libtl_copy_sum((void *)target, te,
+						       te_size);
+			} else if (target != va) {
+				counted_memmove((void *)target, te, te_size);
+			}
+		}
+
+		if (copy && target > cursor) {
+			/* fill the alignment gap with a dummy TE */
+			dummy_te = (struct transfer_list_entry *)cursor;
+			dummy_te->tag_id = TL_TAG_EMPTY;
+			dummy_te->hdr_size = sizeof(*dummy_te);
+			dummy_te->data_size =
+				target - cursor - sizeof(*dummy_te);
+			libtl_stat_add(dummy_entries, 1);
+			if (sum) {
+				*sum += libtl_byte_sum(dummy_te,
+						       target - cursor);
+			}
+		}
+
+		ev = target + te_size;
+		cursor = libtl_align_up(ev, TRANSFER_LIST_GRANULE);
+	}
+
+	return ev;
+}
+
 struct transfer_list_header *
 transfer_list_relocate(struct transfer_list_header *tl, void *addr,
 		       size_t max_size)
 {
-	uintptr_t new_addr, align_mask, align_off;
 	struct transfer_list_header *new_tl;
+	uintptr_t new_addr;
 	uint32_t new_max_size;
 
+	libtl_stat_call(TL_STAT_RELOCATE);
+
 	if (!tl || !addr || max_size == 0) {
 		return NULL;
 	}
 
-	align_mask = (1 << tl->alignment) - 1;
-	align_off = (uintptr_t)tl & align_mask;
-	new_addr = ((uintptr_t)addr & ~align_mask) + align_off;
+	/* the checksum of a list in a batch session is not valid yet */
+	if (tl->flags & TL_FLAGS_LIBTL_BATCH) {
+		error("Cannot relocate transfer list inside a batch session\n");
+		return NULL;
+	}
 
-	if (new_addr < (uintptr_t)addr) {
-		new_addr += (1 << tl->alignment);
+	if (tl->flags & TL_FLAGS_LIBTL_RESERVED) {
+		error("Cannot relocate reserved transfer list\n");
+		return NULL;
 	}
 
-	new_max_size = max_size - (new_addr - (uintptr_t)addr);
+	new_addr = relocate_target(tl, addr, max_size, &new_max_size);
 
 	/* the new space is not sufficient for the tl */
-	if (tl->size > new_max_size) {
+	if (!new_addr || tl->size > new_max_size) {
 		return NULL;
 	}
 
 	new_tl = (struct transfer_list_header *)new_addr;
-	memmove(new_tl, tl, tl->size);
+	counted_memmove(new_tl, tl, tl->size);
+	checksum_sync(new_tl);
+
+	/* the copied bytes sum up as before, only max_size changes */
+	checksum_remove(new_tl, &new_tl->max_size, sizeof(new_tl->max_size));
 	new_tl->max_size = new_max_size;
+	checksum_add(new_tl, &new_tl->max_size, sizeof(new_tl->max_size));
 
-	transfer_list_update_checksum(new_tl);
+	checksum_check(new_tl);
 
 	return new_tl;
 }
 
-enum transfer_list_ops
-transfer_list_check_header(const struct transfer_list_header *tl)
+struct transfer_list_header *
+transfer_list_relocate_compact(struct transfer_list_header *tl, void *addr,
+			       size_t max_size)
 {
-	if (tl == NULL) {
-		return TL_OPS_NON;
-	}
+	struct transfer_list_header hdr, *new_tl;
+	struct transfer_list_entry *idx_te;
+	uintptr_t new_addr, dst;
+	uint32_t new_max_size, new_size;
+	uint8_t sum = 0;
 
-	if (tl->signature != TRANSFER_LIST_SIGNATURE) {
-		warn("Bad transfer list signature %#" PRIx32 "\n",
-		     tl->signature);
-		return TL_OPS_NON;
-	}
+	libtl_stat_call(TL_STAT_RELOCATE_COMPACT);
 
-	if (tl->max_size == 0U) {
-		warn("Bad transfer list max size %#" PRIx32 "\n", tl->max_size);
-		return TL_OPS_NON;
+	if (!tl || !addr || max_size == 0 || tl->hdr_size != sizeof(hdr)) {
+		return NULL;
 	}
 
-	if (tl->size > tl->max_size) {
-		warn("Bad transfer list size %#" PRIx32 "\n", tl->size);
-		return TL_OPS_NON;
+	/* the checksum of a list in a batch session is not valid yet */
+	if (tl->flags & TL_FLAGS_LIBTL_BATCH) {
+		error("Cannot relocate transfer list inside a batch session\n");
+		return NULL;
 	}
 
-	if (tl->hdr_size != sizeof(struct transfer_list_header)) {
-		warn("Bad transfer list header size %#" PRIx32 "\n",
-		     tl->hdr_size);
-		return TL_OPS_NON;
+	if (tl->flags & TL_FLAGS_LIBTL_RESERVED) {
+		error("Cannot relocate reserved transfer list\n");
+		return NULL;
 	}
 
+	/*
+	 * The checksum of the new list is summed up from the copied bytes, which
+	 * would silently turn a corrupt source into a valid list.
+	 */
+	checksum_sync(tl);
 	if (!transfer_list_verify_checksum(tl)) {
-		warn("Bad transfer list checksum %#" PRIx32 "\n", tl->checksum);
-		return TL_OPS_NON;
+		error("Cannot relocate transfer list with a bad checksum\n");
+		return NULL;
 	}
 
-	if (tl->version == 0U) {
-		warn("Transfer list version is invalid\n");
-		return TL_OPS_NON;
-	} else if (tl->version == TRANSFER_LIST_VERSION) {
-		info("Transfer list version is valid for all operations\n");
-		return TL_OPS_ALL;
-	} else if (tl->version > TRANSFER_LIST_VERSION) {
-		info("Transfer list version is valid for read-only\n");
-		return TL_OPS_RO;
+	new_addr = relocate_target(tl, addr, max_size, &new_max_size);
+	if (!new_addr) {
+		return NULL;
 	}
 
-	info("Old transfer list version is detected\n");
-	return TL_OPS_CUS;
-}
-
-struct transfer_list_entry *transfer_list_next(struct transfer_list_header *tl,
-					       struct transfer_list_entry *last)
+	/* lay the list out first, leaving it untouched if it does not fit */
+	new_size = compact_entries(tl, new_addr, false, NULL) - new_addr;
+	if (new_size > new_max_size) {
+		return NULL;
+	}
+
+	/*
+	 * The source header may get overwritten once entries are copied to an
+	 * overlapping destination below it.
+	 */
+	hdr = *tl;
+
+	/*
+	 * A destination that overlaps the source from above is compacted in
+	 * place first and then moved up as a whole.
+	 */
+	dst = new_addr;
+	if (new_addr > (uintptr_t)tl && new_addr < (uintptr_t)tl + tl->size) {
+		dst = (uintptr_t)tl;
+	}
+
+	compact_entries(tl, dst, true, dst == new_addr ? &sum : NULL);
+	if (dst != new_addr) {
+		sum = libtl_copy_sum((void *)(new_addr + hdr.hdr_size),
+				     (void *)(dst + hdr.hdr_size),
+				     new_size - hdr.hdr_size);
+	}
+
+	new_tl = (struct transfer_list_header *)new_addr;
+	hdr.size = new_size;
+	hdr.max_size = new_max_size;
+	hdr.flags &= ~TL_FLAGS_LIBTL_DIRTY;
+	if (hdr.flags & TL_FLAGS_HAS_CHECKSUM) {
+		hdr.checksum = 0;
+	}
+	memcpy(new_tl, &hdr, sizeof(hdr));
+	sum += libtl_byte_sum(new_tl, sizeof(hdr));
+
+	/* the entries moved, so the offsets in an index have to be redone */
+	idx_te = index_te(new_tl);
+	if (idx_te) {
+		sum -= libtl_byte_sum(transfer_list_entry_data(idx_te),
+				      idx_te->data_size);
+		index_fill(new_tl, idx_te);
+		sum += libtl_byte_sum(transfer_list_entry_data(idx_te),
+				      idx_te->data_size);
+	}
+
+	if (new_tl->flags & TL_FLAGS_HAS_CHECKSUM) {
+		new_tl->checksum = -sum;
+	}
+
+	checksum_check(new_tl);
+
+	return new_tl;
+}
+
+/*******************************************************************************
+ * Check the header fields of a transfer list other than its checksum and
+ * version.
+ * Return true if they are valid.
+ ******************************************************************************/
+static bool check_header_fields(const struct transfer_list_header *tl)
 {
-	struct transfer_list_entry *te = NULL;
-	uintptr_t tl_ev = 0;
-	uintptr_t va = 0;
-	uintptr_t ev = 0;
-	size_t sz = 0;
+	if (tl->signature != TRANSFER_LIST_SIGNATURE) {
+		warn("Bad transfer list signature %#" PRIx32 "\n",
+		     tl->signature);
+		return false;
+	}
+
+	if (tl->max_size == 0U) {
+		warn("Bad transfer list max size %#" PRIx32 "\n", tl->max_size);
+		return false;
+	}
+
+	if (tl->size > tl->max_size) {
+		warn("Bad transfer list size %#" PRIx32 "\n", tl->size);
+		return false;
+	}
+
+	if (tl->hdr_size != sizeof(struct transfer_list_header)) {
+		warn("Bad transfer list header size %#" PRIx32 "\n",
+		     tl->hdr_size);
+		return false;
+	}
+
+	return true;
+}
+
+/*******************************************************************************
+ * Return the operations allowed by the version of a transfer list
+ ******************************************************************************/
+static enum transfer_list_ops
+version_ops(const struct transfer_list_header *tl)
+{
+	if (tl->version == 0U) {
+		warn("Transfer list version is invalid\n");
+		return TL_OPS_NON;
+	} else if (tl->version == TRANSFER_LIST_VERSION) {
+		verbose("Transfer list version is valid for all operations\n");
+		return TL_OPS_ALL;
+	} else if (tl->version > TRANSFER_LIST_VERSION) {
+		verbose("Transfer list version is valid for read-only\n");
+		return TL_OPS_RO;
+	}
+
+	info("Old transfer list version is detected\n");
+	return TL_OPS_CUS;
+}
+
+enum transfer_list_ops
+transfer_list_check_header(const struct transfer_list_header *tl)
+{
+	libtl_stat_call(TL_STAT_CHECK_HEADER);
 
 	if (tl == NULL) {
-		return NULL;
+		return TL_OPS_NON;
 	}
 
-	tl_ev = (uintptr_t)tl + tl->size;
+	if (!check_header_fields(tl)) {
+		return TL_OPS_NON;
+	}
 
-	if (last != NULL) {
-		va = (uintptr_t)last;
-		/* check if the total size overflow */
-		if (libtl_add_overflow(last->hdr_size, last->data_size, &sz)) {
-			return NULL;
+	if (!transfer_list_verify_checksum(tl)) {
+		warn("Bad transfer list checksum %#" PRIx32 "\n", tl->checksum);
+		return TL_OPS_NON;
+	}
+
+	return version_ops(tl);
+}
+
+enum transfer_list_ops
+libtl_validate(const struct transfer_list_header *tl,
+	       struct transfer_list_report *report,
+	       uint8_t (*list_sum)(const void *addr, size_t size, void *arg),
+	       void *arg)
+{
+	const struct transfer_list_entry *te;
+	bool has_checksum, sum_entries;
+	uintptr_t base = (uintptr_t)tl;
+	uint64_t te_end;
+	uint32_t off, next;
+	uintptr_t data;
+	uint8_t sum = 0, align;
+
+	libtl_stat_call(TL_STAT_VALIDATE);
+
+	if (tl == NULL || report == NULL) {
+		return TL_OPS_NON;
+	}
+
+	memset(report, 0, sizeof(*report));
+
+	if (!check_header_fields(tl) || tl->size < tl->hdr_size) {
+		return TL_OPS_NON;
+	}
+
+	/*
+	 * Sum each entry right after checking it, while it is still in the
+	 * cache, so that the list is only streamed through once. A whole-list
+	 * sum function replaces that when given.
+	 */
+	has_checksum = (tl->flags & TL_FLAGS_HAS_CHECKSUM) != 0U;
+	sum_entries = has_checksum && list_sum == NULL;
+	if (sum_entries) {
+		sum = libtl_byte_sum(tl, tl->hdr_size);
+	} else if (has_checksum) {
+		sum = list_sum(tl, tl->size, arg);
+	}
+
+	for (off = tl->hdr_size; off < tl->size; off = next) {
+		te = (const struct transfer_list_entry *)(base + off);
+		te_end = (uint64_t)off + sizeof(*te);
+		if (te_end <= tl->size) {
+			te_end = (uint64_t)off + te->hdr_size + te->data_size;
 		}
-		/* roundup to the next entry */
-		if (libtl_add_with_round_up_overflow(
-			    va, sz, TRANSFER_LIST_GRANULE, &va)) {
-			return NULL;
+
+		if (!libtl_is_aligned(base + off, TRANSFER_LIST_GRANULE) ||
+		    te_end > tl->size || te->hdr_size < sizeof(*te)) {
+			report->bad_offset = off;
+			break;
+		}
+
+		next = (uint32_t)libtl_align_up((uintptr_t)te_end,
+						TRANSFER_LIST_GRANULE);
+		if (next > tl->size) {
+			next = tl->size;
+		}
+		if (sum_entries) {
+			sum += libtl_byte_sum(te, next - off);
+		}
+
+		report->entry_count++;
+		if (te->tag_id == TL_TAG_EMPTY) {
+			report->empty_bytes += next - off;
+			continue;
+		}
+
+		data = base + off + te->hdr_size;
+		for (align = 0; align < 31U; align++) {
+			if (!libtl_is_aligned(data, 1UL << (align + 1))) {
+				break;
+			}
+		}
+		if (align > report->max_alignment) {
+			report->max_alignment = align;
 		}
-	} else {
-		va = (uintptr_t)tl + tl->hdr_size;
 	}
 
-	te = (struct transfer_list_entry *)va;
+	if (sum_entries && off < tl->size) {
+		sum += libtl_byte_sum((void *)(base + off), tl->size - off);
+	}
+	report->checksum_ok = (sum == 0U);
 
-	if (((va + sizeof(*te)) > tl_ev) || ((te->hdr_size) < (sizeof(*te))) ||
-	    libtl_add_overflow(te->hdr_size, te->data_size, &sz) ||
-	    libtl_add_overflow(va, sz, &ev) || (ev > tl_ev)) {
-		return NULL;
+	if (!report->checksum_ok) {
+		warn("Bad transfer list checksum %#" PRIx32 "\n", tl->checksum);
+		return TL_OPS_NON;
+	}
+
+	if (report->bad_offset != 0U) {
+		warn("Malformed transfer entry at offset %#" PRIx32 "\n",
+		     report->bad_offset);
+		return TL_OPS_NON;
+	}
+
+	return version_ops(tl);
+}
+
+enum transfer_list_ops
+transfer_list_validate(const struct transfer_list_header *tl,
+		       struct transfer_list_report *report)
+{
+	return libtl_validate(tl, report, NULL, NULL);
+}
+
+struct transfer_list_entry *transfer_list_next(struct transfer_list_header *tl,
+					       struct transfer_list_entry *last)
+{
+	struct transfer_list_entry *te;
+
+	libtl_stat_call(TL_STAT_NEXT);
+
+	te = libtl_inline_next(tl, last);
+	if (te != NULL) {
+		libtl_stat_add(entries_stepped, 1);
 	}
 
 	return te;
@@ -217,6 +910,8 @@ struct transfer_list_entry *transfer_list_prev(struct transfer_list_header *tl,
 	struct transfer_list_entry *prev;
 	struct transfer_list_entry *te = NULL;
 
+	libtl_stat_call(TL_STAT_PREV);
+
 	if (!last || !tl || (tl + tl->hdr_size == (void *)last)) {
 		return NULL;
 	}
@@ -230,39 +925,143 @@ struct transfer_list_entry *transfer_list_prev(struct transfer_list_header *tl,
 }
 
 /*******************************************************************************
- * Calculate the byte sum of a transfer list
- * Return byte sum of the transfer list
+ * Iterator history of the offsets of the entries preceding the current one
  ******************************************************************************/
-static uint8_t calc_byte_sum(const struct transfer_list_header *tl)
+static void iter_push(struct transfer_list_iter *it,
+		      struct transfer_list_entry *te)
+{
+	it->hist[it->top] = (uintptr_t)te - (uintptr_t)it->tl;
+	it->top = (it->top + 1) % TRANSFER_LIST_ITER_DEPTH;
+	if (it->depth < TRANSFER_LIST_ITER_DEPTH) {
+		it->depth++;
+	}
+}
+
+static struct transfer_list_entry *iter_peek(struct transfer_list_iter *it)
+{
+	uint32_t slot;
+
+	if (it->depth == 0) {
+		/* history exhausted, fall back to a rescan */
+		return transfer_list_prev(it->tl, it->te);
+	}
+
+	slot = (it->top + TRANSFER_LIST_ITER_DEPTH - 1) %
+	       TRANSFER_LIST_ITER_DEPTH;
+	return (struct transfer_list_entry *)((uintptr_t)it->tl +
+					      it->hist[slot]);
+}
+
+static void iter_pop(struct transfer_list_iter *it)
+{
+	if (it->depth > 0) {
+		it->top = (it->top + TRANSFER_LIST_ITER_DEPTH - 1) %
+			  TRANSFER_LIST_ITER_DEPTH;
+		it->depth--;
+	}
+}
+
+void transfer_list_iter_init(struct transfer_list_iter *it,
+			     struct transfer_list_header *tl)
+{
+	if (it == NULL) {
+		return;
+	}
+
+	it->tl = tl;
+	it->te = NULL;
+	it->top = 0;
+	it->depth = 0;
+}
+
+struct transfer_list_entry *
+transfer_list_iter_next(struct transfer_list_iter *it)
 {
-	uint8_t *b = (uint8_t *)tl;
-	uint8_t cs = 0;
-	size_t n = 0;
+	struct transfer_list_entry *te;
+
+	if (it == NULL) {
+		return NULL;
+	}
+
+	te = transfer_list_next(it->tl, it->te);
+	if (te == NULL) {
+		transfer_list_iter_init(it, it->tl);
+		return NULL;
+	}
+
+	if (it->te != NULL) {
+		iter_push(it, it->te);
+	}
+	it->te = te;
+
+	return te;
+}
 
-	for (n = 0; n < tl->size; n++) {
-		cs += b[n];
+struct transfer_list_entry *
+transfer_list_iter_prev(struct transfer_list_iter *it)
+{
+	if (it == NULL || it->te == NULL) {
+		return NULL;
 	}
 
-	return cs;
+	it->te = iter_peek(it);
+	iter_pop(it);
+
+	return it->te;
 }
 
 void transfer_list_update_checksum(struct transfer_list_header *tl)
 {
 	uint8_t cs;
 
-	if (!tl || !(tl->flags & TL_FLAGS_HAS_CHECKSUM)) {
+	libtl_stat_call(TL_STAT_UPDATE_CHECKSUM);
+
+	if (!tl) {
+		return;
+	}
+
+	tl->flags &= ~TL_FLAGS_LIBTL_DIRTY;
+	if (!(tl->flags & TL_FLAGS_HAS_CHECKSUM)) {
 		return;
 	}
 
-	cs = calc_byte_sum(tl);
+	cs = libtl_byte_sum(tl, tl->size);
 	cs -= tl->checksum;
 	cs = 256 - cs;
 	tl->checksum = cs;
 	assert(transfer_list_verify_checksum(tl));
 }
 
+bool transfer_list_batch_begin(struct transfer_list_header *tl)
+{
+	if (!tl) {
+		return false;
+	}
+
+	if (tl->flags & TL_FLAGS_LIBTL_BATCH) {
+		error("Transfer list batch session already open\n");
+		return false;
+	}
+
+	tl->flags |= TL_FLAGS_LIBTL_BATCH;
+	return true;
+}
+
+bool transfer_list_batch_commit(struct transfer_list_header *tl)
+{
+	if (!tl || !(tl->flags & TL_FLAGS_LIBTL_BATCH)) {
+		return false;
+	}
+
+	tl->flags &= ~TL_FLAGS_LIBTL_BATCH;
+	transfer_list_update_checksum(tl);
+	return true;
+}
+
 bool transfer_list_verify_checksum(const struct transfer_list_header *tl)
 {
+	libtl_stat_call(TL_STAT_VERIFY_CHECKSUM);
+
 	if (tl == NULL) {
 		return false;
 	}
@@ -271,7 +1070,7 @@ bool transfer_list_verify_checksum(const struct transfer_list_header *tl)
 		return true;
 	}
 
-	return (calc_byte_sum(tl) == 0U);
+	return (libtl_byte_sum(tl, tl->size) == 0U);
 }
 
 bool transfer_list_set_data_size(struct transfer_list_header *tl,
@@ -280,14 +1079,19 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 {
 	uintptr_t tl_old_ev, new_ev = 0, old_ev = 0, merge_ev, ru_new_ev;
 	struct transfer_list_entry *dummy_te = NULL;
+	struct transfer_list_index *idx;
 	size_t gap = 0;
 	size_t mov_dis = 0;
 	size_t sz = 0;
 
+	libtl_stat_call(TL_STAT_SET_DATA_SIZE);
+
 	if (!tl || !te) {
 		return false;
 	}
+	checksum_sync(tl);
 	tl_old_ev = (uintptr_t)tl + tl->size;
+	idx = index_get(tl);
 
 	/*
 	 * calculate the old and new end of TE
@@ -304,6 +1108,48 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 		return false;
 	}
 
+	/*
+	 * An empty TE behind te can be merged into it when te grows. If that
+	 * empty TE is the last one, the list ends right behind it rather than
+	 * at the next granule.
+	 */
+	merge_ev = old_ev;
+	if (new_ev > old_ev && old_ev < tl_old_ev) {
+		dummy_te = transfer_list_next(tl, te);
+		if (dummy_te && (dummy_te->tag_id == TL_TAG_EMPTY)) {
+			merge_ev = libtl_align_up(old_ev + dummy_te->hdr_size +
+							  dummy_te->data_size,
+						  TRANSFER_LIST_GRANULE);
+			if (merge_ev > tl_old_ev) {
+				merge_ev = tl_old_ev;
+			}
+		}
+	}
+
+	/*
+	 * The list ends right behind its last TE, not at the next granule,
+	 * so resizing that TE, or growing it over an empty last TE, only
+	 * moves the end of the list.
+	 */
+	if (old_ev >= tl_old_ev || merge_ev == tl_old_ev) {
+		if ((uintptr_t)te + sz > (uintptr_t)tl + tl->max_size) {
+			return false;
+		}
+		if ((uintptr_t)te + sz < tl_old_ev) {
+			checksum_remove(tl, (void *)((uintptr_t)te + sz),
+					tl_old_ev - ((uintptr_t)te + sz));
+		}
+		checksum_remove(tl, &tl->size, sizeof(tl->size));
+		tl->size = (uintptr_t)te + sz - (uintptr_t)tl;
+		checksum_add(tl, &tl->size, sizeof(tl->size));
+		if ((uintptr_t)te + sz > tl_old_ev) {
+			checksum_add(tl, (void *)tl_old_ev,
+				     (uintptr_t)te + sz - tl_old_ev);
+		}
+		index_sync(tl, idx, false);
+		goto set_dummy;
+	}
+
 	if (new_ev > old_ev) {
 		/*
 		 * When next transfer list is dummy,
@@ -313,18 +1159,11 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 		 *   - otherwise, merge dummy entry with existing te and
 		 *     extend transfer list as much as it requires.
 		 */
-		dummy_te = transfer_list_next(tl, te);
-		if (dummy_te && (dummy_te->tag_id == TL_TAG_EMPTY)) {
-			merge_ev = libtl_align_up(old_ev + dummy_te->hdr_size +
-							  dummy_te->data_size,
-						  TRANSFER_LIST_GRANULE);
-			if (merge_ev >= new_ev) {
-				gap = merge_ev - new_ev;
-				goto set_dummy;
-			} else {
-				old_ev = merge_ev;
-			}
+		if (merge_ev >= new_ev) {
+			gap = merge_ev - new_ev;
+			goto set_dummy;
 		}
+		old_ev = merge_ev;
 
 		/*
 		 * move distance should be roundup
@@ -339,8 +1178,17 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 			return false;
 		}
 		ru_new_ev = old_ev + mov_dis;
-		memmove((void *)ru_new_ev, (void *)old_ev, tl_old_ev - old_ev);
+		counted_memmove((void *)ru_new_ev, (void *)old_ev,
+				tl_old_ev - old_ev);
+		checksum_remove(tl, &tl->size, sizeof(tl->size));
 		tl->size += mov_dis;
+		checksum_add(tl, &tl->size, sizeof(tl->size));
+		/*
+		 * the moved bytes still sum up as before, only the opened up
+		 * region in front of them is new to the checksum
+		 */
+		checksum_add(tl, (void *)old_ev, mov_dis);
+		index_shift(tl, idx, old_ev - (uintptr_t)tl, mov_dis);
 		gap = ru_new_ev - new_ev;
 	} else {
 		gap = old_ev - new_ev;
@@ -350,34 +1198,49 @@ set_dummy:
 	if (gap >= sizeof(*dummy_te)) {
 		/* create a dummy TE to fill up the gap */
 		dummy_te = (struct transfer_list_entry *)new_ev;
+		checksum_remove(tl, dummy_te, sizeof(*dummy_te));
 		dummy_te->tag_id = TL_TAG_EMPTY;
 		dummy_te->hdr_size = sizeof(*dummy_te);
 		dummy_te->data_size = gap - sizeof(*dummy_te);
+		libtl_stat_add(dummy_entries, 1);
+		checksum_add(tl, dummy_te, sizeof(*dummy_te));
+	}
+
+	if (new_data_size > te->data_size) {
+		/* the caller fills in the added data */
+		checksum_mark_dirty(tl);
 	}
 
+	checksum_remove(tl, te, sizeof(*te));
 	te->data_size = new_data_size;
+	checksum_add(tl, te, sizeof(*te));
+
+	checksum_check(tl);
 
-	transfer_list_update_checksum(tl);
 	return true;
 }
 
-bool transfer_list_rem(struct transfer_list_header *tl,
-		       struct transfer_list_entry *te)
+/*******************************************************************************
+ * Turn te into an empty TE, coalescing it with its neighbours prev and next if
+ * those are empty as well.
+ * Return pointer to the resulting empty TE
+ ******************************************************************************/
+static struct transfer_list_entry *
+rem_entry(struct transfer_list_header *tl, struct transfer_list_entry *te,
+	  struct transfer_list_entry *prev, struct transfer_list_entry *next)
 {
-	struct transfer_list_entry *prev;
-	struct transfer_list_entry *next;
-
-	if (!tl || !te || (uintptr_t)te > (uintptr_t)tl + tl->size) {
-		return false;
+	/* removing the index itself leaves nothing to maintain */
+	if (te != index_te(tl)) {
+		index_remove(tl, index_get(tl), te);
 	}
 
-	prev = transfer_list_prev(tl, te);
-	next = transfer_list_next(tl, te);
-
 	if (prev && prev->tag_id == TL_TAG_EMPTY) {
+		checksum_remove(tl, prev, sizeof(*prev));
 		prev->data_size += libtl_align_up(te->hdr_size + te->data_size,
 						  TRANSFER_LIST_GRANULE);
 		te = prev;
+	} else {
+		checksum_remove(tl, te, sizeof(*te));
 	}
 
 	if (next && next->tag_id == TL_TAG_EMPTY) {
@@ -387,23 +1250,71 @@ bool transfer_list_rem(struct transfer_list_header *tl,
 	}
 
 	te->tag_id = TL_TAG_EMPTY;
-	transfer_list_update_checksum(tl);
-	return true;
+	checksum_add(tl, te, sizeof(*te));
+
+	checksum_check(tl);
+
+	return te;
 }
 
-struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
-					      uint32_t tag_id,
-					      uint32_t data_size,
-					      const void *data)
+bool transfer_list_rem(struct transfer_list_header *tl,
+		       struct transfer_list_entry *te)
 {
-	uintptr_t tl_ev;
-	struct transfer_list_entry *te = NULL;
-	uint8_t *te_data = NULL;
-	uintptr_t te_end;
+	libtl_stat_call(TL_STAT_REM);
 
-	if (!tl || (tag_id & (1 << 24))) {
+	if (!tl || !te || (uintptr_t)te > (uintptr_t)tl + tl->size) {
+		return false;
+	}
+
+	checksum_sync(tl);
+	rem_entry(tl, te, transfer_list_prev(tl, te),
+		  transfer_list_next(tl, te));
+	return true;
+}
+
+bool transfer_list_rem_at(struct transfer_list_iter *it)
+{
+	struct transfer_list_entry *prev;
+	struct transfer_list_entry *te;
+
+	if (it == NULL || it->tl == NULL || it->te == NULL) {
+		return false;
+	}
+
+	checksum_sync(it->tl);
+	prev = iter_peek(it);
+	te = rem_entry(it->tl, it->te, prev,
+		       transfer_list_next(it->tl, it->te));
+
+	/* the current entry was merged into the preceding one */
+	if (te == prev) {
+		iter_pop(it);
+	}
+	it->te = te;
+
+	return true;
+}
+
+/*******************************************************************************
+ * Append a TE to the list. With data_pending, the data of the TE is left out
+ * of the checksum, to be accounted for by transfer_list_commit() once it has
+ * been written.
+ * Return pointer to the added TE or NULL on error
+ ******************************************************************************/
+static struct transfer_list_entry *
+add_entry(struct transfer_list_header *tl, uint32_t tag_id, uint32_t data_size,
+	  const void *data, bool data_pending)
+{
+	uintptr_t tl_ev;
+	struct transfer_list_entry *te = NULL;
+	struct transfer_list_index *idx;
+	uint8_t *te_data = NULL;
+	uintptr_t te_end;
+
+	if (!tl || (tag_id & (1 << 24))) {
 		return NULL;
 	}
+	checksum_sync(tl);
 
 	/*
 	 * skip the step 1 (optional step)
@@ -418,10 +1329,14 @@ struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
 		return NULL;
 	}
 
+	idx = index_get(tl);
+
 	te->tag_id = tag_id;
 	te->hdr_size = sizeof(*te);
 	te->data_size = data_size;
+	checksum_remove(tl, &tl->size, sizeof(tl->size));
 	tl->size += te_end - tl_ev;
+	checksum_add(tl, &tl->size, sizeof(tl->size));
 
 	if (data) {
 		/* get TE data pointer */
@@ -429,18 +1344,41 @@ struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
 		if (!te_data) {
 			return NULL;
 		}
-		memmove(te_data, data, data_size);
+		counted_memmove(te_data, data, data_size);
 	}
 
-	transfer_list_update_checksum(tl);
+	/* only the padding, the new TE header and its data join the sum */
+	if (data_pending) {
+		te_end -= data_size;
+	}
+	checksum_add(tl, (void *)tl_ev, te_end - tl_ev);
+	index_insert(tl, idx, te);
+
+	if (!data && !data_pending && data_size && tag_id != TL_TAG_EMPTY) {
+		/* the caller fills in the data */
+		checksum_mark_dirty(tl);
+	}
+
+	if (!data_pending) {
+		checksum_check(tl);
+	}
 
 	return te;
 }
 
-struct transfer_list_entry *
-transfer_list_add_with_align(struct transfer_list_header *tl, uint32_t tag_id,
-			     uint32_t data_size, const void *data,
-			     uint8_t alignment)
+struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
+					      uint32_t tag_id,
+					      uint32_t data_size,
+					      const void *data)
+{
+	libtl_stat_call(TL_STAT_ADD);
+	return add_entry(tl, tag_id, data_size, data, false);
+}
+
+static struct transfer_list_entry *
+add_entry_with_align(struct transfer_list_header *tl, uint32_t tag_id,
+		     uint32_t data_size, const void *data, uint8_t alignment,
+		     bool data_pending)
 {
 	struct transfer_list_entry *te = NULL;
 	uintptr_t tl_ev, ev, new_tl_ev;
@@ -463,43 +1401,750 @@ transfer_list_add_with_align(struct transfer_list_header *tl, uint32_t tag_id,
 			    sizeof(struct transfer_list_entry);
 		dummy_te_data_sz =
 			new_tl_ev - tl_ev - sizeof(struct transfer_list_entry);
-		if (!transfer_list_add(tl, TL_TAG_EMPTY, dummy_te_data_sz,
-				       NULL)) {
+		if (!add_entry(tl, TL_TAG_EMPTY, dummy_te_data_sz, NULL,
+			       false)) {
 			return NULL;
 		}
+		libtl_stat_add(dummy_entries, 1);
 	}
 
-	te = transfer_list_add(tl, tag_id, data_size, data);
+	te = add_entry(tl, tag_id, data_size, data, data_pending);
 	if (te == NULL) {
 		return NULL;
 	}
 
 	if (alignment > tl->alignment) {
+		checksum_remove(tl, &tl->alignment, sizeof(tl->alignment));
 		tl->alignment = alignment;
-		transfer_list_update_checksum(tl);
+		checksum_add(tl, &tl->alignment, sizeof(tl->alignment));
+	}
+
+	if (!data_pending) {
+		checksum_check(tl);
+	}
+
+	return te;
+}
+
+struct transfer_list_entry *
+transfer_list_add_with_align(struct transfer_list_header *tl, uint32_t tag_id,
+			     uint32_t data_size, const void *data,
+			     uint8_t alignment)
+{
+	libtl_stat_call(TL_STAT_ADD_WITH_ALIGN);
+	return add_entry_with_align(tl, tag_id, data_size, data, alignment,
+				    false);
+}
+
+/*******************************************************************************
+ * Set or clear the reservation flag of a list
+ ******************************************************************************/
+static void set_reserved(struct transfer_list_header *tl, bool reserved)
+{
+	checksum_remove(tl, &tl->flags, sizeof(tl->flags));
+	if (reserved) {
+		tl->flags |= TL_FLAGS_LIBTL_RESERVED;
+	} else {
+		tl->flags &= ~TL_FLAGS_LIBTL_RESERVED;
+	}
+	checksum_add(tl, &tl->flags, sizeof(tl->flags));
+}
+
+struct transfer_list_entry *
+transfer_list_reserve(struct transfer_list_header *tl, uint32_t tag_id,
+		      uint32_t max_size, uint8_t alignment)
+{
+	struct transfer_list_entry *te;
+
+	libtl_stat_call(TL_STAT_RESERVE);
+
+	if (!tl || (tl->flags & TL_FLAGS_LIBTL_RESERVED)) {
+		return NULL;
+	}
+
+	/*
+	 * The data is yet to be written, so the checksum is not valid until
+	 * the reservation is committed.
+	 */
+	checksum_sync(tl);
+	set_reserved(tl, true);
+	te = add_entry_with_align(tl, tag_id, max_size, NULL, alignment, true);
+	if (te == NULL) {
+		set_reserved(tl, false);
+		return NULL;
 	}
 
 	return te;
 }
 
+bool transfer_list_commit(struct transfer_list_header *tl,
+			  struct transfer_list_entry *te, uint32_t data_size)
+{
+	struct transfer_list_entry *dummy_te;
+	struct transfer_list_index *idx;
+	uintptr_t data, old_ev, new_ev;
+	uint32_t old_data_size;
+
+	libtl_stat_call(TL_STAT_COMMIT);
+
+	if (!tl || !te || !(tl->flags & TL_FLAGS_LIBTL_RESERVED) ||
+	    (uintptr_t)te < (uintptr_t)tl + tl->hdr_size ||
+	    (uintptr_t)te + sizeof(*te) > (uintptr_t)tl + tl->size ||
+	    !libtl_is_aligned((uintptr_t)te, TRANSFER_LIST_GRANULE) ||
+	    data_size > te->data_size) {
+		return false;
+	}
+
+	idx = index_get(tl);
+	data = (uintptr_t)transfer_list_entry_data(te);
+	old_data_size = te->data_size;
+	old_ev = data + old_data_size;
+	new_ev = libtl_align_up(data + data_size, TRANSFER_LIST_GRANULE);
+
+	checksum_remove(tl, te, sizeof(*te));
+	te->data_size = data_size;
+	checksum_add(tl, te, sizeof(*te));
+
+	if (old_ev == (uintptr_t)tl + tl->size) {
+		/* the reserved TE is the last one, give the slack back */
+		checksum_remove(tl, &tl->size, sizeof(tl->size));
+		tl->size = data + data_size - (uintptr_t)tl;
+		checksum_add(tl, &tl->size, sizeof(tl->size));
+		checksum_add(tl, (void *)data, data_size);
+		index_sync(tl, idx, false);
+	} else {
+		/*
+		 * TEs were added behind it, turn the slack into a dummy TE.
+		 * The padding behind the reserved data was accounted for when
+		 * the next TE was added.
+		 */
+		checksum_remove(tl, (void *)old_ev,
+				libtl_align_up(old_ev, TRANSFER_LIST_GRANULE) -
+					old_ev);
+		old_ev = libtl_align_up(old_ev, TRANSFER_LIST_GRANULE);
+		if (old_ev - new_ev >= sizeof(*dummy_te)) {
+			dummy_te = (struct transfer_list_entry *)new_ev;
+			dummy_te->tag_id = TL_TAG_EMPTY;
+			dummy_te->hdr_size = sizeof(*dummy_te);
+			dummy_te->data_size =
+				old_ev - new_ev - sizeof(*dummy_te);
+			libtl_stat_add(dummy_entries, 1);
+		}
+		checksum_add(tl, (void *)data, old_ev - data);
+	}
+
+	set_reserved(tl, false);
+
+	/* entries added while the reservation was outstanding may be dirty */
+	checksum_sync(tl);
+
+	checksum_check(tl);
+
+	return true;
+}
+
+bool transfer_list_reserve_abort(struct transfer_list_header *tl,
+				 struct transfer_list_entry *te)
+{
+	struct transfer_list_index *idx;
+
+	/* give the slack back first */
+	if (!transfer_list_commit(tl, te, 0)) {
+		return false;
+	}
+
+	if ((uintptr_t)te + te->hdr_size != (uintptr_t)tl + tl->size) {
+		return transfer_list_rem(tl, te);
+	}
+
+	/* the TE is the last one, drop it altogether */
+	idx = index_get(tl);
+	index_remove(tl, idx, te);
+	checksum_remove(tl, te, sizeof(*te));
+	checksum_remove(tl, &tl->size, sizeof(tl->size));
+	tl->size = (uintptr_t)te - (uintptr_t)tl;
+	checksum_add(tl, &tl->size, sizeof(tl->size));
+	index_sync(tl, idx, false);
+
+	checksum_check(tl);
+
+	return true;
+}
+
+struct transfer_list_entry *
+transfer_list_resize(struct transfer_list_header *tl,
+		     struct transfer_list_entry *te, uint32_t new_data_size,
+		     enum transfer_list_resize_policy policy)
+{
+	struct transfer_list_entry *next, *new_te;
+	uintptr_t old_ev, new_ev, data_va, align;
+	size_t te_size, tail_size;
+	void *new_data;
+	uint8_t alignment;
+
+	libtl_stat_call(TL_STAT_RESIZE);
+
+	if (!tl || !te) {
+		return NULL;
+	}
+
+	te_size = te->hdr_size + te->data_size;
+	old_ev = libtl_align_up((uintptr_t)te + te_size, TRANSFER_LIST_GRANULE);
+	new_ev = libtl_align_up((uintptr_t)te + te->hdr_size + new_data_size,
+				TRANSFER_LIST_GRANULE);
+
+	if (policy != TL_RESIZE_MIN_MOVE || new_ev <= old_ev) {
+		goto in_place;
+	}
+
+	/* a following empty TE is absorbed before anything gets moved */
+	next = transfer_list_next(tl, te);
+	if (next && next->tag_id == TL_TAG_EMPTY) {
+		old_ev = libtl_align_up(old_ev + next->hdr_size +
+						next->data_size,
+					TRANSFER_LIST_GRANULE);
+		if (old_ev >= new_ev) {
+			goto in_place;
+		}
+	}
+
+	/* a last TE, possibly behind an empty one, just moves the list end */
+	if (old_ev >= (uintptr_t)tl + tl->size) {
+		goto in_place;
+	}
+
+	tail_size = (uintptr_t)tl + tl->size - old_ev;
+	if (tail_size <= te_size) {
+		goto in_place;
+	}
+
+	/*
+	 * Moving the TEs behind it costs more than moving the TE itself, so
+	 * re-add it at the tail, keeping its data at least as aligned as it is
+	 * now, and leave an empty TE in its place.
+	 */
+	data_va = (uintptr_t)transfer_list_entry_data(te);
+	align = data_va & -data_va;
+	alignment = 0;
+	while (alignment < tl->alignment && (align >> alignment) > 1) {
+		alignment++;
+	}
+
+	new_te = add_entry_with_align(tl, te->tag_id, new_data_size, NULL,
+				      alignment, true);
+	if (new_te == NULL) {
+		goto in_place;
+	}
+
+	/* the moved data and the grown part join the sum as they are */
+	new_data = transfer_list_entry_data(new_te);
+	counted_memmove(new_data, (void *)data_va, te->data_size);
+	checksum_add(tl, new_data, new_data_size);
+	/* the caller fills in the added data */
+	checksum_mark_dirty(tl);
+
+	/*
+	 * Finding the TE in front of it would take a walk from the start of
+	 * the list, so an empty TE there is left for transfer_list_compact()
+	 * to merge, like the one transfer_list_set_data_size() leaves behind
+	 * a shrunk TE.
+	 */
+	rem_entry(tl, te, NULL, transfer_list_next(tl, te));
+	return new_te;
+
+in_place:
+	return transfer_list_set_data_size(tl, te, new_data_size) ? te : NULL;
+}
+
+/*******************************************************************************
+ * Work out where a TE with data_size bytes of data aligned to 1 << alignment
+ * fits into the empty TE hole.
+ * Return the TE address, or 0 if it does not fit
+ ******************************************************************************/
+static uintptr_t fit_in_hole(struct transfer_list_header *tl,
+			     struct transfer_list_entry *hole,
+			     uint32_t data_size, uint8_t alignment,
+			     uintptr_t *hole_end)
+{
+	uintptr_t va = (uintptr_t)hole;
+	uintptr_t tl_ev = (uintptr_t)tl + tl->size;
+	uintptr_t te_va, te_end;
+
+	*hole_end = libtl_align_up(va + hole->hdr_size + hole->data_size,
+				   TRANSFER_LIST_GRANULE);
+	if (*hole_end > tl_ev) {
+		*hole_end = tl_ev;
+	}
+
+	te_va = libtl_align_up(va + sizeof(struct transfer_list_entry),
+			       1UL << alignment) -
+		sizeof(struct transfer_list_entry);
+	if (te_va < va) {
+		te_va = va;
+	}
+
+	/* keep room for a dummy TE in front of the new TE */
+	if (te_va != va && te_va - va < sizeof(struct transfer_list_entry)) {
+		return 0;
+	}
+
+	if (libtl_add_overflow(te_va + sizeof(struct transfer_list_entry),
+			       data_size, &te_end) ||
+	    te_end > *hole_end) {
+		return 0;
+	}
+
+	return te_va;
+}
+
+struct transfer_list_entry *
+transfer_list_add_placed(struct transfer_list_header *tl, uint32_t tag_id,
+			 uint32_t data_size, const void *data,
+			 uint8_t alignment, enum transfer_list_placement place)
+{
+	struct transfer_list_entry *te = NULL, *hole = NULL, *dummy_te;
+	uintptr_t te_va = 0, hole_end = 0, va, end, tail;
+	struct transfer_list_index *idx;
+	size_t slack = SIZE_MAX;
+
+	libtl_stat_call(TL_STAT_ADD_PLACED);
+
+	if (!tl || (tag_id & (1 << 24)) || alignment >= 32) {
+		return NULL;
+	}
+
+	while (place != TL_PLACE_APPEND &&
+	       (te = transfer_list_next(tl, te)) != NULL) {
+		if (te->tag_id != TL_TAG_EMPTY ||
+		    !(va = fit_in_hole(tl, te, data_size, alignment, &end))) {
+			continue;
+		}
+
+		if (end - va - data_size < slack) {
+			hole = te;
+			te_va = va;
+			hole_end = end;
+			slack = end - va - data_size;
+		}
+
+		if (place == TL_PLACE_FIRST_FIT) {
+			break;
+		}
+	}
+
+	if (hole == NULL) {
+		return transfer_list_add_with_align(tl, tag_id, data_size,
+						    data, alignment);
+	}
+
+	checksum_sync(tl);
+	idx = index_get(tl);
+	te = (struct transfer_list_entry *)te_va;
+	end = te_va + sizeof(*te) + data_size;
+	tail = libtl_align_up(end, TRANSFER_LIST_GRANULE);
+
+	/* the list ends right behind its last TE, so cut a last hole back */
+	if (hole_end == (uintptr_t)tl + tl->size) {
+		checksum_remove(tl, (void *)end, hole_end - end);
+		checksum_remove(tl, &tl->size, sizeof(tl->size));
+		tl->size = end - (uintptr_t)tl;
+		checksum_add(tl, &tl->size, sizeof(tl->size));
+		hole_end = end;
+	}
+
+	if (te_va != (uintptr_t)hole) {
+		checksum_remove(tl, hole, sizeof(*hole));
+	}
+	checksum_remove(tl, te, sizeof(*te) + data_size);
+	if (tail < hole_end && hole_end - tail >= sizeof(*dummy_te)) {
+		checksum_remove(tl, (void *)tail, sizeof(*dummy_te));
+	}
+
+	/* split the hole into a dummy TE, the new TE and another dummy TE */
+	if (te_va != (uintptr_t)hole) {
+		hole->data_size = te_va - (uintptr_t)hole - hole->hdr_size;
+	}
+
+	te->tag_id = tag_id;
+	te->hdr_size = sizeof(*te);
+	te->data_size = data_size;
+	if (data) {
+		counted_memmove(transfer_list_entry_data(te), data, data_size);
+	}
+
+	if (tail < hole_end && hole_end - tail >= sizeof(*dummy_te)) {
+		dummy_te = (struct transfer_list_entry *)tail;
+		dummy_te->tag_id = TL_TAG_EMPTY;
+		dummy_te->hdr_size = sizeof(*dummy_te);
+		dummy_te->data_size = hole_end - tail - sizeof(*dummy_te);
+		libtl_stat_add(dummy_entries, 1);
+		checksum_add(tl, dummy_te, sizeof(*dummy_te));
+	}
+
+	checksum_add(tl, te, sizeof(*te) + data_size);
+	if (te_va != (uintptr_t)hole) {
+		checksum_add(tl, hole, sizeof(*hole));
+	}
+
+	if (alignment > tl->alignment) {
+		checksum_remove(tl, &tl->alignment, sizeof(tl->alignment));
+		tl->alignment = alignment;
+		checksum_add(tl, &tl->alignment, sizeof(tl->alignment));
+	}
+
+	index_insert(tl, idx, te);
+
+	if (!data && data_size) {
+		/* the caller fills in the data */
+		checksum_mark_dirty(tl);
+	}
+
+	checksum_check(tl);
+
+	return te;
+}
+
+/*******************************************************************************
+ * Lay out the TE described by desc at the list end ev, inserting an empty TE
+ * first if needed to meet its data alignment.
+ * Return the end of the new TE, or 0 if it does not fit below max_ev
+ ******************************************************************************/
+static uintptr_t layout_desc(const struct transfer_list_entry_desc *desc,
+			     uintptr_t ev, uintptr_t max_ev,
+			     uintptr_t *dummy_va, uintptr_t *te_va)
+{
+	uintptr_t va, data_va, te_end;
+
+	if (desc->tag_id & (1 << 24) || desc->alignment >= 32) {
+		return 0;
+	}
+
+	va = libtl_align_up(ev, TRANSFER_LIST_GRANULE);
+	data_va = va + sizeof(struct transfer_list_entry);
+	*dummy_va = 0;
+
+	if (!libtl_is_aligned(data_va, 1 << desc->alignment)) {
+		*dummy_va = va;
+		va = libtl_align_up(data_va, 1 << desc->alignment) -
+		     sizeof(struct transfer_list_entry);
+	}
+
+	if (libtl_add_overflow(va + sizeof(struct transfer_list_entry),
+			       desc->data_size, &te_end) ||
+	    te_end > max_ev) {
+		return 0;
+	}
+
+	*te_va = va;
+	return te_end;
+}
+
+bool transfer_list_add_many(struct transfer_list_header *tl,
+			    const struct transfer_list_entry_desc *descs,
+			    size_t n)
+{
+	uintptr_t tl_ev, ev, max_ev, dummy_va, te_va;
+	struct transfer_list_entry *te;
+	struct transfer_list_index *idx;
+	bool dirty = false;
+	uint8_t alignment;
+	size_t i;
+
+	libtl_stat_call(TL_STAT_ADD_MANY);
+
+	if (!tl || (!descs && n > 0)) {
+		return false;
+	}
+
+	/* lay out every TE up front so that nothing is written on failure */
+	tl_ev = (uintptr_t)tl + tl->size;
+	max_ev = (uintptr_t)tl + tl->max_size;
+	alignment = tl->alignment;
+	for (i = 0, ev = tl_ev; i < n; i++) {
+		ev = layout_desc(&descs[i], ev, max_ev, &dummy_va, &te_va);
+		if (ev == 0) {
+			return false;
+		}
+		if (descs[i].alignment > alignment) {
+			alignment = descs[i].alignment;
+		}
+	}
+
+	checksum_sync(tl);
+	idx = index_get(tl);
+
+	checksum_remove(tl, &tl->size, sizeof(tl->size));
+	checksum_remove(tl, &tl->alignment, sizeof(tl->alignment));
+	tl->size += ev - tl_ev;
+	tl->alignment = alignment;
+	checksum_add(tl, &tl->size, sizeof(tl->size));
+	checksum_add(tl, &tl->alignment, sizeof(tl->alignment));
+
+	for (i = 0, ev = tl_ev; i < n; i++) {
+		ev = layout_desc(&descs[i], ev, max_ev, &dummy_va, &te_va);
+
+		if (dummy_va) {
+			te = (struct transfer_list_entry *)dummy_va;
+			te->tag_id = TL_TAG_EMPTY;
+			te->hdr_size = sizeof(*te);
+			te->data_size = te_va - dummy_va - sizeof(*te);
+			libtl_stat_add(dummy_entries, 1);
+		}
+
+		te = (struct transfer_list_entry *)te_va;
+		te->tag_id = descs[i].tag_id;
+		te->hdr_size = sizeof(*te);
+		te->data_size = descs[i].data_size;
+		if (descs[i].data) {
+			counted_memmove(transfer_list_entry_data(te),
+					descs[i].data, descs[i].data_size);
+		} else if (descs[i].data_size) {
+			dirty = true;
+		}
+
+		index_insert(tl, idx, te);
+		if (idx && idx->tl_size != tl->size) {
+			/* the index ran out of capacity and went stale */
+			idx = NULL;
+		}
+	}
+
+	checksum_add(tl, (void *)tl_ev, ev - tl_ev);
+
+	if (dirty) {
+		/* the caller fills in the data */
+		checksum_mark_dirty(tl);
+	}
+
+	checksum_check(tl);
+
+	return true;
+}
+
+uint32_t transfer_list_compact(struct transfer_list_header *tl)
+{
+	struct transfer_list_index *idx;
+	uint32_t old_size;
+
+	libtl_stat_call(TL_STAT_COMPACT);
+
+	if (!tl) {
+		return 0;
+	}
+
+	if (tl->flags & TL_FLAGS_LIBTL_RESERVED) {
+		error("Cannot compact reserved transfer list\n");
+		return 0;
+	}
+
+	idx = index_get(tl);
+	old_size = tl->size;
+	tl->size = compact_entries(tl, (uintptr_t)tl, true, NULL) -
+		   (uintptr_t)tl;
+	if (idx) {
+		index_fill(tl, index_te(tl));
+	}
+
+	if (!(tl->flags & TL_FLAGS_LIBTL_BATCH)) {
+		transfer_list_update_checksum(tl);
+	}
+
+	return old_size - tl->size;
+}
+
+bool transfer_list_view_open(struct transfer_list_view *view,
+			     struct transfer_list_header *tl)
+{
+	struct transfer_list_report report;
+	enum transfer_list_ops ops;
+
+	if (view == NULL) {
+		return false;
+	}
+
+	ops = transfer_list_validate(tl, &report);
+	if (ops != TL_OPS_ALL && ops != TL_OPS_RO) {
+		return false;
+	}
+
+	view->tl = tl;
+	view->end = (uintptr_t)tl + tl->size;
+	view->count = report.entry_count;
+
+	return true;
+}
+
+/*******************************************************************************
+ * Walk the list once, starting after last (or from the head if last is NULL),
+ * and store the first TE found for each of the n tags in out. Entries of out
+ * for tags that are not found are set to NULL. The walk stops early once all
+ * tags have been found.
+ * Return the number of tags found.
+ ******************************************************************************/
+static size_t find_walk(struct transfer_list_header *tl,
+			struct transfer_list_entry *last, const uint32_t *tags,
+			size_t n, struct transfer_list_entry **out)
+{
+	struct transfer_list_entry *te = last;
+	size_t i, found = 0;
+
+	for (i = 0; i < n; i++) {
+		out[i] = NULL;
+	}
+
+	while (found < n && (te = transfer_list_next(tl, te)) != NULL) {
+		for (i = 0; i < n; i++) {
+			if (!out[i] && tags[i] == te->tag_id) {
+				out[i] = te;
+				found++;
+			}
+		}
+	}
+
+	return found;
+}
+
 struct transfer_list_entry *transfer_list_find(struct transfer_list_header *tl,
 					       uint32_t tag_id)
+{
+	libtl_stat_call(TL_STAT_FIND);
+	return transfer_list_find_next(tl, tag_id, NULL);
+}
+
+struct transfer_list_entry *
+transfer_list_find_next(struct transfer_list_header *tl, uint32_t tag_id,
+			struct transfer_list_entry *last)
 {
 	struct transfer_list_entry *te = NULL;
+	struct transfer_list_index *idx;
 
-	do {
-		te = transfer_list_next(tl, te);
-	} while ((te != NULL) && (te->tag_id != tag_id));
+	libtl_stat_call(TL_STAT_FIND_NEXT);
+
+	idx = index_get(tl);
+	if (idx && index_is_indexed(tag_id) &&
+	    index_find(tl, idx, tag_id, last, &te)) {
+		return te;
+	}
+
+	find_walk(tl, last, &tag_id, 1, &te);
 
 	return te;
 }
 
-void *transfer_list_entry_data(struct transfer_list_entry *entry)
+size_t transfer_list_find_many(struct transfer_list_header *tl,
+			       const uint32_t *tags, size_t n,
+			       struct transfer_list_entry **out)
+{
+	struct transfer_list_index *idx;
+	size_t i, found = 0;
+
+	libtl_stat_call(TL_STAT_FIND_MANY);
+
+	if (!tl || !tags || !out) {
+		return 0;
+	}
+
+	idx = index_get(tl);
+	if (idx) {
+		for (i = 0; i < n; i++) {
+			if (!index_is_indexed(tags[i]) ||
+			    !index_find(tl, idx, tags[i], NULL, &out[i])) {
+				break;
+			}
+			if (out[i]) {
+				found++;
+			}
+		}
+		if (i == n) {
+			return found;
+		}
+	}
+
+	return find_walk(tl, NULL, tags, n, out);
+}
+
+struct transfer_list_entry *
+transfer_list_index_create(struct transfer_list_header *tl, uint32_t capacity)
 {
-	if (entry == NULL) {
+	struct transfer_list_entry *te;
+	uintptr_t first;
+	size_t mov_dis;
+
+	if (!tl) {
+		return NULL;
+	}
+
+	if (tl->flags & TL_FLAGS_LIBTL_RESERVED) {
+		error("Cannot index reserved transfer list\n");
 		return NULL;
 	}
-	return (uint8_t *)entry + entry->hdr_size;
+
+	te = index_te(tl);
+	if (te) {
+		return transfer_list_index_rebuild(tl) ? te : NULL;
+	}
+	checksum_sync(tl);
+
+	/*
+	 * The index has to be the first TE so it can be located without a
+	 * walk. Make room for it by moving all TEs up, by a distance that
+	 * keeps their data aligned.
+	 */
+	if (capacity > (UINT32_MAX - sizeof(struct transfer_list_index)) /
+			       sizeof(struct transfer_list_index_entry)) {
+		return NULL;
+	}
+	mov_dis = sizeof(*te) + sizeof(struct transfer_list_index) +
+		  capacity * sizeof(struct transfer_list_index_entry);
+	mov_dis = libtl_align_up(mov_dis, 1 << tl->alignment);
+	if (mov_dis > tl->max_size - tl->size) {
+		return NULL;
+	}
+
+	first = (uintptr_t)tl + tl->hdr_size;
+	counted_memmove((void *)(first + mov_dis), (void *)first,
+			tl->size - tl->hdr_size);
+	checksum_remove(tl, &tl->size, sizeof(tl->size));
+	tl->size += mov_dis;
+	checksum_add(tl, &tl->size, sizeof(tl->size));
+
+	/* any alignment padding becomes spare index capacity */
+	te = (struct transfer_list_entry *)first;
+	te->tag_id = TL_TAG_LIBTL_INDEX;
+	te->hdr_size = sizeof(*te);
+	te->data_size = mov_dis - sizeof(*te);
+	index_fill(tl, te);
+
+	/* the moved TEs still sum up as before */
+	checksum_add(tl, te, mov_dis);
+
+	checksum_check(tl);
+
+	return te;
+}
+
+bool transfer_list_index_rebuild(struct transfer_list_header *tl)
+{
+	struct transfer_list_entry *te;
+	bool ret;
+
+	if (!tl || !(te = index_te(tl))) {
+		return false;
+	}
+	checksum_sync(tl);
+
+	checksum_remove(tl, transfer_list_entry_data(te), te->data_size);
+	ret = index_fill(tl, te);
+	checksum_add(tl, transfer_list_entry_data(te), te->data_size);
+
+	checksum_check(tl);
+
+	return ret;
+}
+
+void *transfer_list_entry_data(struct transfer_list_entry *entry)
+{
+	return libtl_inline_entry_data(entry);
 }
 
 struct transfer_list_header *transfer_list_ensure(void *addr, size_t size)
@@ -514,3 +2159,37 @@ struct transfer_list_header *transfer_list_ensure(void *addr, size_t size)
 
 	return tl;
 }
+
+bool transfer_list_stats_get(struct transfer_list_stats *stats)
+{
+#if defined(LIBTL_STATS)
+	size_t i;
+#endif
+
+	if (stats == NULL) {
+		return false;
+	}
+
+#if defined(LIBTL_STATS)
+	/* the counters are all uint64_t */
+	for (i = 0; i < sizeof(*stats) / sizeof(uint64_t); i++) {
+		((uint64_t *)stats)[i] =
+			libtl_stat_load(((uint64_t *)&libtl_stats)[i]);
+	}
+	return true;
+#else
+	memset(stats, 0, sizeof(*stats));
+	return false;
+#endif
+}
+
+void transfer_list_stats_reset(void)
+{
+#if defined(LIBTL_STATS)
+	size_t i;
+
+	for (i = 0; i < sizeof(libtl_stats) / sizeof(uint64_t); i++) {
+		libtl_stat_store(((uint64_t *)&libtl_stats)[i], 0);
+	}
+#endif
+}
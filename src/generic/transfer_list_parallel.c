@@ -0,0 +1,114 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <private/checksum.h>
+#include <private/stats.h>
+#include <private/validate.h>
+#include <transfer_list_parallel.h>
+
+/* upper bound on the number of threads a list is split across */
+#define MAX_THREADS 64U
+
+/* chunk boundaries are kept cache line aligned */
+#define CHUNK_ALIGN 64U
+
+struct sum_chunk {
+	const uint8_t *addr;
+	size_t size;
+	uint8_t sum;
+	pthread_t thread;
+	bool started;
+};
+
+static void *sum_worker(void *arg)
+{
+	struct sum_chunk *chunk = arg;
+
+	chunk->sum = libtl_byte_sum(chunk->addr, chunk->size);
+
+	return NULL;
+}
+
+/*******************************************************************************
+ * Calculate the byte sum of a memory region, split across up to
+ * *(unsigned int *)arg threads. The calling thread sums the first chunk, and
+ * any chunk whose thread could not be started.
+ ******************************************************************************/
+static uint8_t parallel_byte_sum(const void *addr, size_t size, void *arg)
+{
+	struct sum_chunk chunks[MAX_THREADS];
+	unsigned int i, threads = *(unsigned int *)arg;
+	size_t chunk_size;
+	uint8_t sum = 0;
+	long cpus;
+
+	if (threads == 0U) {
+		cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = (cpus > 0) ? (unsigned int)cpus : 1U;
+	}
+	if (threads > MAX_THREADS) {
+		threads = MAX_THREADS;
+	}
+	if (threads > size / TRANSFER_LIST_PARALLEL_MIN_CHUNK) {
+		threads = size / TRANSFER_LIST_PARALLEL_MIN_CHUNK;
+	}
+	if (threads <= 1U) {
+		return libtl_byte_sum(addr, size);
+	}
+
+	chunk_size = (size / threads + CHUNK_ALIGN - 1) &
+		     ~(size_t)(CHUNK_ALIGN - 1);
+	for (i = 0; i < threads; i++) {
+		chunks[i].addr = (const uint8_t *)addr + i * chunk_size;
+		chunks[i].size = chunk_size;
+		if (i == threads - 1U) {
+			chunks[i].size = size - i * chunk_size;
+		}
+		chunks[i].started = false;
+		if (i != 0U && pthread_create(&chunks[i].thread, NULL,
+					      sum_worker, &chunks[i]) == 0) {
+			chunks[i].started = true;
+		}
+	}
+
+	for (i = 0; i < threads; i++) {
+		if (chunks[i].started) {
+			pthread_join(chunks[i].thread, NULL);
+		} else {
+			sum_worker(&chunks[i]);
+		}
+		sum += chunks[i].sum;
+	}
+
+	return sum;
+}
+
+bool transfer_list_verify_checksum_parallel(
+	const struct transfer_list_header *tl, unsigned int threads)
+{
+	libtl_stat_call(TL_STAT_VERIFY_CHECKSUM);
+
+	if (tl == NULL) {
+		return false;
+	}
+
+	if ((tl->flags & TL_FLAGS_HAS_CHECKSUM) == 0U) {
+		return true;
+	}
+
+	return (parallel_byte_sum(tl, tl->size, &threads) == 0U);
+}
+
+enum transfer_list_ops
+transfer_list_validate_parallel(const struct transfer_list_header *tl,
+				struct transfer_list_report *report,
+				unsigned int threads)
+{
+	return libtl_validate(tl, report, parallel_byte_sum, &threads);
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#include <string.h>
+
+#include <transfer_list_seqlock.h>
+
+/*******************************************************************************
+ * Look up an entry and copy out its data, without trusting anything read from
+ * the list, which may be modified at the same time. Every entry field is read
+ * once, so that the values that were bounds checked are the ones used.
+ * Return true if the entry was found.
+ ******************************************************************************/
+static bool snapshot_find(const struct transfer_list_header *tl,
+			  uint32_t tag_id, void *buf, uint32_t buf_size,
+			  uint32_t *data_size)
+{
+	const struct transfer_list_entry *te;
+	uint32_t hdr_size, te_data_size;
+	uint64_t off, end, ev;
+
+	end = tl->size;
+	if (end > tl->max_size) {
+		return false;
+	}
+
+	off = tl->hdr_size;
+	off = (off + TRANSFER_LIST_GRANULE - 1) &
+	      ~(uint64_t)(TRANSFER_LIST_GRANULE - 1);
+
+	while (off + sizeof(*te) <= end) {
+		te = (const struct transfer_list_entry *)((uintptr_t)tl + off);
+
+		hdr_size = te->hdr_size;
+		te_data_size = te->data_size;
+
+		/* 64-bit arithmetic, this cannot overflow */
+		ev = off + hdr_size + te_data_size;
+		if (hdr_size < sizeof(*te) || ev > end) {
+			return false;
+		}
+
+		if (te->tag_id == tag_id) {
+			*data_size = te_data_size;
+			/* buf may be NULL when only the size is asked for */
+			if (buf_size != 0U) {
+				memcpy(buf, (const uint8_t *)te + hdr_size,
+				       (te_data_size < buf_size) ?
+					       te_data_size :
+					       buf_size);
+			}
+			return true;
+		}
+
+		off = (ev + TRANSFER_LIST_GRANULE - 1) &
+		      ~(uint64_t)(TRANSFER_LIST_GRANULE - 1);
+	}
+
+	return false;
+}
+
+bool transfer_list_read_find(const struct transfer_list_header *tl,
+			     struct transfer_list_seqlock *lock,
+			     uint32_t tag_id, void *buf, uint32_t *size)
+{
+	uint32_t seq, data_size = 0;
+	bool found;
+
+	if (tl == NULL || lock == NULL || size == NULL ||
+	    (buf == NULL && *size != 0)) {
+		return false;
+	}
+
+	do {
+		seq = transfer_list_read_begin(lock);
+		found = snapshot_find(tl, tag_id, buf, *size, &data_size);
+	} while (transfer_list_read_retry(lock, seq));
+
+	if (found) {
+		*size = data_size;
+	}
+
+	return found;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "private/checksum.h"
+#include "unity.h"
+
+#define BUF_SIZE 0x1000
+
+uint8_t *buffer = NULL;
+
+static uint8_t ref_byte_sum(const uint8_t *b, size_t len)
+{
+	uint8_t sum = 0;
+
+	for (size_t i = 0; i < len; i++) {
+		sum += b[i];
+	}
+
+	return sum;
+}
+
+void test_byte_sum_matches_reference()
+{
+	/* Cover every head misalignment and tail length of the kernels. */
+	for (size_t off = 0; off < 64; off++) {
+		for (size_t len = 0; len < 200; len++) {
+			TEST_ASSERT_EQUAL_UINT8(
+				ref_byte_sum(buffer + off, len),
+				libtl_byte_sum(buffer + off, len));
+		}
+	}
+
+	TEST_ASSERT_EQUAL_UINT8(ref_byte_sum(buffer, BUF_SIZE),
+				libtl_byte_sum(buffer, BUF_SIZE));
+}
+
+void test_byte_sum_saturated()
+{
+	/* All lanes wrap many times over. */
+	for (size_t i = 0; i < BUF_SIZE; i++) {
+		buffer[i] = 0xff;
+	}
+
+	TEST_ASSERT_EQUAL_UINT8(ref_byte_sum(buffer, BUF_SIZE),
+				libtl_byte_sum(buffer, BUF_SIZE));
+	TEST_ASSERT_EQUAL_UINT8(ref_byte_sum(buffer + 3, BUF_SIZE - 5),
+				libtl_byte_sum(buffer + 3, BUF_SIZE - 5));
+}
+
+void test_copy_sum_overlap()
+{
+	uint8_t *ref = malloc(BUF_SIZE);
+	uint8_t *copy = malloc(BUF_SIZE);
+
+	/* Both copy directions, with and without overlap. */
+	for (size_t dst = 0; dst < BUF_SIZE / 2; dst += 0x1a3) {
+		for (size_t src = 0; src < BUF_SIZE / 2; src += 0x155) {
+			size_t len = BUF_SIZE / 2 - 7;
+
+			memcpy(ref, buffer, BUF_SIZE);
+			memcpy(copy, buffer, BUF_SIZE);
+			memmove(ref + dst, ref + src, len);
+			TEST_ASSERT_EQUAL_UINT8(
+				ref_byte_sum(ref + dst, len),
+				libtl_copy_sum(copy + dst, copy + src, len));
+			TEST_ASSERT_EQUAL_MEMORY(ref, copy, BUF_SIZE);
+		}
+	}
+
+	free(copy);
+	free(ref);
+}
+
+void setUp(void)
+{
+	buffer = malloc(BUF_SIZE);
+	srand(0);
+	for (size_t i = 0; i < BUF_SIZE; i++) {
+		buffer[i] = rand();
+	}
+}
+
+void tearDown(void)
+{
+	free(buffer);
+	buffer = NULL;
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_byte_sum_matches_reference);
+	RUN_TEST(test_byte_sum_saturated);
+	RUN_TEST(test_copy_sum_overlap);
+	return UNITY_END();
+}
@@ -179,6 +179,615 @@ void test_set_data_size()
 	TEST_ASSERT(byte_sum((void *)tl, tl->size) == 0);
 	TEST_ASSERT(te[0]->data_size == tl->max_size / 2);
 	TEST_ASSERT(tl_size < tl->size);
+
+	/* The list ends right behind a last TE of unaligned size. */
+	TEST_ASSERT(te[2] = transfer_list_add(tl, tag_base + 3, 0x5,
+					      test_page_data));
+	tl_size = (uintptr_t)te[2] - (uintptr_t)tl + sizeof(*te[2]);
+	TEST_ASSERT(transfer_list_set_data_size(tl, te[2], 0x13));
+	TEST_ASSERT_EQUAL(tl_size + 0x13, tl->size);
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+	TEST_ASSERT(transfer_list_set_data_size(tl, te[2], 0x3));
+	TEST_ASSERT_EQUAL(tl_size + 0x3, tl->size);
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+	TEST_ASSERT_EQUAL_PTR(te[2], transfer_list_find(tl, tag_base + 3));
+	TEST_ASSERT_NULL(transfer_list_next(tl, te[2]));
+
+	/* Growing it over an empty last TE of unaligned size. */
+	TEST_ASSERT(te[1] = transfer_list_add(tl, tag_base + 4, 0x5,
+					      test_page_data));
+	te[1]->tag_id = TL_TAG_EMPTY;
+	transfer_list_update_checksum(tl);
+	TEST_ASSERT(transfer_list_set_data_size(tl, te[2], 0x10));
+	TEST_ASSERT_EQUAL(tl_size + 0x10, tl->size);
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+	TEST_ASSERT_NULL(transfer_list_next(tl, te[2]));
+
+	TEST_ASSERT(te[1] = transfer_list_add(tl, tag_base + 4, 0x5,
+					      test_page_data));
+	te[1]->tag_id = TL_TAG_EMPTY;
+	transfer_list_update_checksum(tl);
+	TEST_ASSERT(transfer_list_set_data_size(tl, te[2], 0x40));
+	TEST_ASSERT_EQUAL(tl_size + 0x40, tl->size);
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+	TEST_ASSERT_NULL(transfer_list_next(tl, te[2]));
+}
+
+void test_checksum_dirty_memory()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_header *new_tl;
+	struct transfer_list_entry *te[3];
+	void *new_buf = malloc(TL_SIZE * 2);
+
+	/*
+	 * Relocate into memory full of garbage so that padding and unused
+	 * payload bytes are non-zero and have to be accounted for by the
+	 * incremental checksum updates.
+	 */
+	memset(new_buf, 0xa5, TL_SIZE * 2);
+	TEST_ASSERT(new_tl = transfer_list_relocate(tl, new_buf, TL_SIZE * 2));
+	TEST_ASSERT(byte_sum((void *)new_tl, new_tl->size) == 0);
+
+	TEST_ASSERT(te[0] = transfer_list_add(new_tl, 1, 13, test_page_data));
+	TEST_ASSERT(byte_sum((void *)new_tl, new_tl->size) == 0);
+	TEST_ASSERT(te[1] = transfer_list_add(new_tl, 2, 0x21, NULL));
+	TEST_ASSERT(byte_sum((void *)new_tl, new_tl->size) == 0);
+	TEST_ASSERT(te[2] = transfer_list_add_with_align(new_tl, 3, 7,
+							 test_page_data, 6));
+	TEST_ASSERT(byte_sum((void *)new_tl, new_tl->size) == 0);
+
+	TEST_ASSERT(transfer_list_set_data_size(new_tl, te[0], 0x105));
+	TEST_ASSERT(byte_sum((void *)new_tl, new_tl->size) == 0);
+
+	/* growing te[0] moved the entries behind it */
+	TEST_ASSERT(te[1] = transfer_list_find(new_tl, 2));
+	TEST_ASSERT(transfer_list_set_data_size(new_tl, te[1], 3));
+	TEST_ASSERT(byte_sum((void *)new_tl, new_tl->size) == 0);
+	TEST_ASSERT(transfer_list_rem(new_tl, te[1]));
+	TEST_ASSERT(byte_sum((void *)new_tl, new_tl->size) == 0);
+	TEST_ASSERT(transfer_list_check_header(new_tl) == TL_OPS_ALL);
+
+	free(new_buf);
+}
+
+void test_checksum_caller_fill()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_header *new_tl;
+	struct transfer_list_entry_desc desc = { test_tag + 3, 0x11, NULL, 0 };
+	struct transfer_list_entry *te;
+
+	/* Data written after adding an entry without data is picked up. */
+	TEST_ASSERT(te = transfer_list_add(tl, test_tag, 0x20, NULL));
+	memset(transfer_list_entry_data(te), 0x5a, 0x20);
+	TEST_ASSERT(transfer_list_add(tl, test_tag + 1, 8, test_page_data));
+	TEST_ASSERT(byte_sum((void *)tl, tl->size) == 0);
+
+	/* So is data written into the grown part of an entry. */
+	TEST_ASSERT(te = transfer_list_find(tl, test_tag + 1));
+	TEST_ASSERT_TRUE(transfer_list_set_data_size(tl, te, 0x30));
+	memset(transfer_list_entry_data(te), 0xa5, 0x30);
+	TEST_ASSERT_TRUE(transfer_list_rem(tl, transfer_list_find(tl, test_tag)));
+	TEST_ASSERT(byte_sum((void *)tl, tl->size) == 0);
+
+	TEST_ASSERT(te = transfer_list_add_placed(tl, test_tag + 2, 0x10, NULL,
+						  0, TL_PLACE_FIRST_FIT));
+	memset(transfer_list_entry_data(te), 0x33, 0x10);
+	TEST_ASSERT_TRUE(transfer_list_add_many(tl, &desc, 1));
+	memset(transfer_list_entry_data(transfer_list_find(tl, test_tag + 3)),
+	       0x77, 0x11);
+	TEST_ASSERT(new_tl = transfer_list_relocate(tl, (char *)buffer + TL_SIZE,
+						    TL_SIZE));
+	TEST_ASSERT(byte_sum((void *)new_tl, new_tl->size) == 0);
+	TEST_ASSERT_EQUAL(TL_FLAGS_HAS_CHECKSUM, new_tl->flags);
+
+	/* The list is handed over after a final checksum update. */
+	TEST_ASSERT(te = transfer_list_add(new_tl, test_tag + 4, 8, NULL));
+	memset(transfer_list_entry_data(te), 0x11, 8);
+	transfer_list_update_checksum(new_tl);
+	TEST_ASSERT_EQUAL(TL_FLAGS_HAS_CHECKSUM, new_tl->flags);
+	TEST_ASSERT(transfer_list_check_header(new_tl) == TL_OPS_ALL);
+
+	/* Lists without a checksum and batch sessions have nothing to resync. */
+	TEST_ASSERT_TRUE(transfer_list_batch_begin(new_tl));
+	TEST_ASSERT(transfer_list_add(new_tl, test_tag + 5, 8, NULL));
+	TEST_ASSERT_TRUE(transfer_list_batch_commit(new_tl));
+	TEST_ASSERT_EQUAL(TL_FLAGS_HAS_CHECKSUM, new_tl->flags);
+	new_tl->flags = 0;
+	TEST_ASSERT(transfer_list_add(new_tl, test_tag + 6, 8, NULL));
+	TEST_ASSERT_EQUAL(0, new_tl->flags);
+}
+
+void test_batch()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_header *other = transfer_list_init(
+		(char *)buffer + TL_SIZE, TL_SIZE);
+	struct transfer_list_entry *te;
+	unsigned int i;
+
+	/* Nothing to commit without a batch session. */
+	TEST_ASSERT_FALSE(transfer_list_batch_commit(tl));
+
+	TEST_ASSERT_TRUE(transfer_list_batch_begin(tl));
+	TEST_ASSERT_FALSE(transfer_list_batch_begin(tl));
+	TEST_ASSERT_FALSE(transfer_list_batch_commit(other));
+
+	/* Sessions on different lists are independent. */
+	TEST_ASSERT_TRUE(transfer_list_batch_begin(other));
+	TEST_ASSERT(transfer_list_add(other, test_tag, sizeof(test_data),
+				      &test_data));
+	TEST_ASSERT_TRUE(transfer_list_batch_commit(other));
+	TEST_ASSERT(transfer_list_check_header(other) == TL_OPS_ALL);
+
+	for (i = 0; i < 8; i++) {
+		TEST_ASSERT(transfer_list_add(tl, test_tag + i, 0x20 + i,
+					      test_page_data));
+	}
+	TEST_ASSERT(transfer_list_add_with_align(tl, test_tag + i, 0x10,
+						 test_page_data, 5));
+	TEST_ASSERT(te = transfer_list_find(tl, test_tag));
+	TEST_ASSERT_TRUE(transfer_list_set_data_size(tl, te, 0x80));
+	TEST_ASSERT(te = transfer_list_find(tl, test_tag + 3));
+	TEST_ASSERT_TRUE(transfer_list_rem(tl, te));
+
+	/* The list cannot be relocated with a stale checksum. */
+	TEST_ASSERT_NULL(transfer_list_relocate(tl, other, TL_SIZE));
+
+	TEST_ASSERT_TRUE(transfer_list_batch_commit(tl));
+	TEST_ASSERT_FALSE(transfer_list_batch_commit(tl));
+	TEST_ASSERT_EQUAL(TL_FLAGS_HAS_CHECKSUM, tl->flags);
+	TEST_ASSERT(byte_sum((void *)tl, tl->size) == 0);
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+	TEST_ASSERT(transfer_list_check_header(other) == TL_OPS_ALL);
+}
+
+void test_iter()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_entry *te[8];
+	struct transfer_list_entry *cur;
+	struct transfer_list_iter it;
+	unsigned int i;
+
+	for (i = 0; i < 8; i++) {
+		TEST_ASSERT(te[i] = transfer_list_add(tl, test_tag + i, 0x10,
+						      test_page_data));
+	}
+
+	transfer_list_iter_init(&it, tl);
+	for (i = 0; i < 8; i++) {
+		TEST_ASSERT_EQUAL_PTR(te[i], transfer_list_iter_next(&it));
+	}
+
+	/* Step back further than the iterator history reaches. */
+	for (i = 7; i-- > 0;) {
+		TEST_ASSERT_EQUAL_PTR(te[i], transfer_list_iter_prev(&it));
+	}
+	TEST_ASSERT_NULL(transfer_list_iter_prev(&it));
+	TEST_ASSERT_EQUAL_PTR(te[0], transfer_list_iter_next(&it));
+
+	/* Remove every entry but the last, coalescing as we go. */
+	transfer_list_iter_init(&it, tl);
+	while ((cur = transfer_list_iter_next(&it)) && cur != te[7]) {
+		if (cur->tag_id != TL_TAG_EMPTY) {
+			TEST_ASSERT_TRUE(transfer_list_rem_at(&it));
+			TEST_ASSERT(byte_sum((void *)tl, tl->size) == 0);
+		}
+	}
+
+	/* Should have one TL_TAG_EMPTY entry followed by the last entry. */
+	TEST_ASSERT_EQUAL_PTR(te[0], transfer_list_find(tl, TL_TAG_EMPTY));
+	TEST_ASSERT_EQUAL_PTR(te[7], transfer_list_next(tl, te[0]));
+	TEST_ASSERT_EQUAL_PTR(te[0], transfer_list_prev(tl, te[7]));
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+}
+
+void test_add_many()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_entry *te;
+	char *snapshot = malloc(TL_SIZE);
+	struct transfer_list_entry_desc descs[] = {
+		{ .tag_id = 1, .data_size = 5, .data = test_page_data },
+		{ .tag_id = 2, .data_size = 0x30, .data = test_page_data,
+		  .alignment = 6 },
+		{ .tag_id = 3, .data_size = 0, .data = NULL },
+		{ .tag_id = 4, .data_size = 0x11, .data = test_page_data,
+		  .alignment = 4 },
+	};
+	struct transfer_list_entry_desc too_big[] = {
+		{ .tag_id = 5, .data_size = 0x10, .data = test_page_data },
+		{ .tag_id = 6, .data_size = TL_SIZE, .data = test_page_data },
+	};
+	struct transfer_list_entry_desc bad_tag[] = {
+		{ .tag_id = 7, .data_size = 0x10, .data = test_page_data },
+		{ .tag_id = 1 << 24, .data_size = 0x10, .data = NULL },
+	};
+
+	TEST_ASSERT_TRUE(transfer_list_add_many(tl, descs, 4));
+	TEST_ASSERT(byte_sum((void *)tl, tl->size) == 0);
+	TEST_ASSERT_EQUAL(6, tl->alignment);
+
+	for (size_t i = 0; i < 4; i++) {
+		TEST_ASSERT(te = transfer_list_find(tl, descs[i].tag_id));
+		TEST_ASSERT_EQUAL(descs[i].data_size, te->data_size);
+		TEST_ASSERT_FALSE((uintptr_t)transfer_list_entry_data(te) %
+				  (1 << descs[i].alignment));
+		if (descs[i].data) {
+			TEST_ASSERT_EQUAL_MEMORY(descs[i].data,
+						 transfer_list_entry_data(te),
+						 descs[i].data_size);
+		}
+	}
+
+	/* A set of entries that does not fit leaves the list untouched. */
+	memcpy(snapshot, tl, TL_SIZE);
+	TEST_ASSERT_FALSE(transfer_list_add_many(tl, too_big, 2));
+	TEST_ASSERT_FALSE(transfer_list_add_many(tl, bad_tag, 2));
+	TEST_ASSERT_EQUAL_MEMORY(snapshot, tl, TL_SIZE);
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+
+	free(snapshot);
+}
+
+void test_compact()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_entry *te[6];
+	uint32_t old_size, empty_size = 0;
+	unsigned int i;
+
+	/* Nothing to reclaim in an empty list. */
+	TEST_ASSERT_EQUAL(0, transfer_list_compact(tl));
+
+	for (i = 0; i < 6; i++) {
+		memset(test_page_data, i, 0x40);
+		if (i == 4) {
+			TEST_ASSERT(te[i] = transfer_list_add_with_align(
+					    tl, test_tag + i, 0x40,
+					    test_page_data, 6));
+		} else {
+			TEST_ASSERT(te[i] = transfer_list_add(
+					    tl, test_tag + i, 0x40 + i,
+					    test_page_data));
+		}
+	}
+
+	TEST_ASSERT_TRUE(transfer_list_rem(tl, te[1]));
+	TEST_ASSERT_TRUE(transfer_list_rem(tl, te[3]));
+	TEST_ASSERT_TRUE(transfer_list_set_data_size(tl, te[2], 0x8));
+	TEST_ASSERT_TRUE(transfer_list_rem(tl, te[5]));
+
+	old_size = tl->size;
+	TEST_ASSERT(transfer_list_compact(tl) > 0);
+	TEST_ASSERT(tl->size < old_size);
+	TEST_ASSERT(byte_sum((void *)tl, tl->size) == 0);
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+
+	for (i = 0; i < 6; i++) {
+		struct transfer_list_entry *found =
+			transfer_list_find(tl, test_tag + i);
+		uint8_t *data;
+
+		if (i == 1 || i == 3 || i == 5) {
+			TEST_ASSERT_NULL(found);
+			continue;
+		}
+
+		TEST_ASSERT_NOT_NULL(found);
+		TEST_ASSERT(data = transfer_list_entry_data(found));
+		TEST_ASSERT_EQUAL(i, data[0]);
+		TEST_ASSERT_EQUAL(i, data[found->data_size - 1]);
+		if (i == 4) {
+			TEST_ASSERT_FALSE((uintptr_t)data % (1 << 6));
+		}
+	}
+
+	/* Only padding for the aligned entry may be left over. */
+	for (te[0] = NULL; (te[0] = transfer_list_next(tl, te[0]));) {
+		if (te[0]->tag_id == TL_TAG_EMPTY) {
+			empty_size += te[0]->hdr_size + te[0]->data_size;
+		}
+	}
+	TEST_ASSERT(empty_size < (1 << 6));
+
+	/* A compact list stays as it is. */
+	TEST_ASSERT_EQUAL(0, transfer_list_compact(tl));
+}
+
+void test_add_placed()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_entry *te[5];
+	struct transfer_list_entry *placed, *next;
+	struct transfer_list_report report;
+	uint32_t tl_size;
+	unsigned int i;
+
+	for (i = 0; i < 5; i++) {
+		TEST_ASSERT(te[i] = transfer_list_add(tl, test_tag + i,
+						      0x40 * (i + 1),
+						      test_page_data));
+	}
+	TEST_ASSERT_TRUE(transfer_list_rem(tl, te[1]));
+	TEST_ASSERT_TRUE(transfer_list_rem(tl, te[3]));
+	tl_size = tl->size;
+
+	/* First fit takes the first hole and leaves the rest behind. */
+	TEST_ASSERT(placed = transfer_list_add_placed(
+			    tl, 0x10, 0x20, test_page_data, 0,
+			    TL_PLACE_FIRST_FIT));
+	TEST_ASSERT_EQUAL_PTR(te[1], placed);
+	TEST_ASSERT(next = transfer_list_next(tl, placed));
+	TEST_ASSERT_EQUAL(TL_TAG_EMPTY, next->tag_id);
+	TEST_ASSERT_EQUAL_PTR(te[2], transfer_list_next(tl, next));
+	TEST_ASSERT(byte_sum((void *)tl, tl->size) == 0);
+
+	/* Best fit prefers the smaller remaining hole. */
+	TEST_ASSERT(placed = transfer_list_add_placed(
+			    tl, 0x11, 0x50, test_page_data, 0,
+			    TL_PLACE_BEST_FIT));
+	TEST_ASSERT((uintptr_t)placed > (uintptr_t)te[1]);
+	TEST_ASSERT((uintptr_t)placed < (uintptr_t)te[2]);
+	TEST_ASSERT(byte_sum((void *)tl, tl->size) == 0);
+
+	/* An aligned entry keeps a dummy TE in front of it. */
+	TEST_ASSERT(placed = transfer_list_add_placed(
+			    tl, 0x12, 0x40, test_page_data, 6,
+			    TL_PLACE_BEST_FIT));
+	TEST_ASSERT((uintptr_t)placed > (uintptr_t)te[3]);
+	TEST_ASSERT((uintptr_t)placed < (uintptr_t)te[4]);
+	TEST_ASSERT_FALSE((uintptr_t)transfer_list_entry_data(placed) %
+			  (1 << 6));
+	TEST_ASSERT_EQUAL(6, tl->alignment);
+	TEST_ASSERT_EQUAL(tl_size, tl->size);
+	TEST_ASSERT(byte_sum((void *)tl, tl->size) == 0);
+
+	/* Nothing fits any more, so the entry is appended. */
+	TEST_ASSERT(placed = transfer_list_add_placed(tl, 0x13, 0x100,
+						      test_page_data, 0,
+						      TL_PLACE_FIRST_FIT));
+	TEST_ASSERT((uintptr_t)placed > (uintptr_t)te[4]);
+	TEST_ASSERT(tl_size < tl->size);
+
+	for (i = 0x10; i <= 0x13; i++) {
+		TEST_ASSERT(placed = transfer_list_find(tl, i));
+		TEST_ASSERT_EQUAL_MEMORY(test_page_data,
+					 transfer_list_entry_data(placed),
+					 placed->data_size);
+	}
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+
+	/* A hole at the end of the list is cut back to the placed entry. */
+	TEST_ASSERT(te[0] = transfer_list_add(tl, 0x14, 0x13, test_page_data));
+	te[0]->tag_id = TL_TAG_EMPTY;
+	transfer_list_update_checksum(tl);
+	TEST_ASSERT(placed = transfer_list_add_placed(tl, 0x15, 0x10,
+						      test_page_data, 0,
+						      TL_PLACE_BEST_FIT));
+	TEST_ASSERT_EQUAL_PTR(te[0], placed);
+	TEST_ASSERT_EQUAL((uintptr_t)placed + sizeof(*placed) + 0x10,
+			  (uintptr_t)tl + tl->size);
+	TEST_ASSERT_NULL(transfer_list_next(tl, placed));
+	TEST_ASSERT(transfer_list_validate(tl, &report) == TL_OPS_ALL);
+}
+
+void test_reserve_commit()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_entry *te, *next;
+	uint8_t *data;
+	uint32_t tl_size;
+
+	TEST_ASSERT(transfer_list_add(tl, test_tag, 3, &test_data));
+	tl_size = tl->size;
+
+	/* Fill the entry in place and give the slack back. */
+	TEST_ASSERT(te = transfer_list_reserve(tl, test_tag + 1, 0x100, 5));
+	TEST_ASSERT_NULL(transfer_list_reserve(tl, test_tag + 2, 0x10, 0));
+	TEST_ASSERT_NULL(transfer_list_relocate(tl, (char *)buffer + TL_SIZE,
+						TL_SIZE));
+	TEST_ASSERT(data = transfer_list_entry_data(te));
+	TEST_ASSERT_FALSE((uintptr_t)data % (1 << 5));
+	memset(data, 0x5a, 0x21);
+	TEST_ASSERT_FALSE(transfer_list_commit(tl, te, 0x101));
+	TEST_ASSERT_TRUE(transfer_list_commit(tl, te, 0x21));
+	TEST_ASSERT_FALSE(transfer_list_commit(tl, te, 0x21));
+	TEST_ASSERT_EQUAL(0x21, te->data_size);
+	TEST_ASSERT_EQUAL((uintptr_t)data + 0x21 - (uintptr_t)tl, tl->size);
+	TEST_ASSERT(tl_size < tl->size);
+	TEST_ASSERT(byte_sum((void *)tl, tl->size) == 0);
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+
+	/* With an entry added behind it, the slack becomes an empty TE. */
+	TEST_ASSERT(te = transfer_list_reserve(tl, test_tag + 2, 0x103, 0));
+	TEST_ASSERT(transfer_list_add(tl, test_tag + 3, 5, test_page_data));
+	TEST_ASSERT(transfer_list_rem(tl, transfer_list_find(tl, test_tag)));
+	TEST_ASSERT_EQUAL(0, transfer_list_compact(tl));
+	TEST_ASSERT_NULL(transfer_list_index_create(tl, 8));
+	memset(transfer_list_entry_data(te), 0xa5, 0x13);
+	TEST_ASSERT_TRUE(transfer_list_commit(tl, te, 0x13));
+	TEST_ASSERT(byte_sum((void *)tl, tl->size) == 0);
+	TEST_ASSERT(next = transfer_list_next(tl, te));
+	TEST_ASSERT_EQUAL(TL_TAG_EMPTY, next->tag_id);
+	TEST_ASSERT_EQUAL_PTR(transfer_list_find(tl, test_tag + 3),
+			      transfer_list_next(tl, next));
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+}
+
+void test_reserve_abort()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_header *other = transfer_list_init(
+		(char *)buffer + TL_SIZE, TL_SIZE);
+	struct transfer_list_entry *te, *other_te;
+	uint32_t tl_size;
+
+	TEST_ASSERT(transfer_list_add(tl, test_tag, 3, &test_data));
+	tl_size = tl->size;
+
+	/* Reservations on different lists are independent. */
+	TEST_ASSERT(te = transfer_list_reserve(tl, test_tag + 1, 0x40, 0));
+	TEST_ASSERT(other_te = transfer_list_reserve(other, test_tag, 0x40, 0));
+	TEST_ASSERT_FALSE(transfer_list_commit(other, te, 0x10));
+
+	/* A producer that fails half way leaves the list as it was. */
+	memset(transfer_list_entry_data(te), 0x5a, 0x20);
+	TEST_ASSERT_TRUE(transfer_list_reserve_abort(tl, te));
+	TEST_ASSERT_FALSE(transfer_list_reserve_abort(tl, te));
+	TEST_ASSERT_NULL(transfer_list_find(tl, test_tag + 1));
+	TEST_ASSERT(tl->size <= tl_size + sizeof(*te));
+	TEST_ASSERT_EQUAL(TL_FLAGS_HAS_CHECKSUM, tl->flags);
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+
+	/* With an entry added behind it, it becomes an empty TE. */
+	TEST_ASSERT(te = transfer_list_reserve(tl, test_tag + 1, 0x40, 0));
+	TEST_ASSERT(transfer_list_add(tl, test_tag + 2, 5, test_page_data));
+	memset(transfer_list_entry_data(te), 0xa5, 0x40);
+	TEST_ASSERT_TRUE(transfer_list_reserve_abort(tl, te));
+	TEST_ASSERT_EQUAL(TL_TAG_EMPTY, te->tag_id);
+	TEST_ASSERT(transfer_list_find(tl, test_tag + 2));
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+
+	TEST_ASSERT_TRUE(transfer_list_commit(other, other_te, 0));
+	TEST_ASSERT(transfer_list_check_header(other) == TL_OPS_ALL);
+}
+
+void test_resize()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_entry *te[4];
+	struct transfer_list_entry *resized;
+	unsigned int i;
+
+	for (i = 0; i < 4; i++) {
+		memset(test_page_data, i, 0x100);
+		TEST_ASSERT(te[i] = transfer_list_add(tl, test_tag + i,
+						      i ? 0x100 : 0x10,
+						      test_page_data));
+	}
+
+	/* Shrinking and stable growth keep the entry in place. */
+	TEST_ASSERT_EQUAL_PTR(te[0], transfer_list_resize(tl, te[0], 0x8,
+							  TL_RESIZE_MIN_MOVE));
+	TEST_ASSERT_EQUAL_PTR(te[0], transfer_list_resize(tl, te[0], 0x18,
+							  TL_RESIZE_STABLE));
+	TEST_ASSERT(byte_sum((void *)tl, tl->size) == 0);
+
+	/* the growth moved the entries behind it */
+	for (i = 1; i < 4; i++) {
+		TEST_ASSERT(te[i] = transfer_list_find(tl, test_tag + i));
+	}
+
+	/* The small first entry moves instead of the large tail. */
+	TEST_ASSERT(resized = transfer_list_resize(tl, te[0], 0x40,
+						   TL_RESIZE_MIN_MOVE));
+	TEST_ASSERT((uintptr_t)resized > (uintptr_t)te[3]);
+	TEST_ASSERT_EQUAL(TL_TAG_EMPTY, te[0]->tag_id);
+	TEST_ASSERT_EQUAL(0x40, resized->data_size);
+	TEST_ASSERT_EQUAL(0, ((uint8_t *)transfer_list_entry_data(resized))[0]);
+	TEST_ASSERT_EQUAL(0,
+			  ((uint8_t *)transfer_list_entry_data(resized))[0x17]);
+	TEST_ASSERT_EQUAL_PTR(resized, transfer_list_find(tl, test_tag));
+	TEST_ASSERT(byte_sum((void *)tl, tl->size) == 0);
+
+	/* A large entry with a small tail moves the tail. */
+	TEST_ASSERT_EQUAL_PTR(te[3], transfer_list_resize(tl, te[3], 0x180,
+							  TL_RESIZE_MIN_MOVE));
+	TEST_ASSERT_EQUAL(3,
+			  ((uint8_t *)transfer_list_entry_data(te[3]))[0xff]);
+	TEST_ASSERT(resized = transfer_list_find(tl, test_tag));
+	TEST_ASSERT((uintptr_t)resized > (uintptr_t)te[3]);
+	TEST_ASSERT_EQUAL(0,
+			  ((uint8_t *)transfer_list_entry_data(resized))[0x17]);
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+
+	/* The place a moved entry leaves stays apart from the hole in front. */
+	TEST_ASSERT(resized = transfer_list_resize(tl, te[1], 0x300,
+						   TL_RESIZE_MIN_MOVE));
+	TEST_ASSERT((uintptr_t)resized > (uintptr_t)te[3]);
+	TEST_ASSERT_EQUAL(TL_TAG_EMPTY, te[0]->tag_id);
+	TEST_ASSERT_EQUAL_PTR(te[1], transfer_list_next(tl, te[0]));
+	TEST_ASSERT_EQUAL(TL_TAG_EMPTY, te[1]->tag_id);
+	TEST_ASSERT_EQUAL_PTR(te[2], transfer_list_next(tl, te[1]));
+	TEST_ASSERT_EQUAL(1,
+			  ((uint8_t *)transfer_list_entry_data(resized))[0xff]);
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+
+	/* A last entry of unaligned size grows in place. */
+	TEST_ASSERT(te[0] = transfer_list_add(tl, test_tag + 4, 5,
+					      test_page_data));
+	TEST_ASSERT_EQUAL_PTR(te[0], transfer_list_resize(tl, te[0], 100,
+							  TL_RESIZE_MIN_MOVE));
+	TEST_ASSERT_EQUAL((uintptr_t)te[0] + sizeof(*te[0]) + 100,
+			  (uintptr_t)tl + tl->size);
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+}
+
+void test_find_many()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_entry *te[4], *out[5], *it;
+	uint32_t tags[] = { test_tag + 2, test_tag, test_tag + 9, test_tag,
+			    test_tag + 1 };
+
+	TEST_ASSERT(te[0] = transfer_list_add(tl, test_tag, 4, &test_data));
+	TEST_ASSERT(te[1] = transfer_list_add(tl, test_tag + 1, 4, &test_data));
+	TEST_ASSERT(te[2] = transfer_list_add(tl, test_tag, 8, test_page_data));
+	TEST_ASSERT(te[3] = transfer_list_add(tl, test_tag + 2, 4, &test_data));
+
+	TEST_ASSERT_EQUAL(4, transfer_list_find_many(tl, tags, 5, out));
+	TEST_ASSERT_EQUAL_PTR(te[3], out[0]);
+	TEST_ASSERT_EQUAL_PTR(te[0], out[1]);
+	TEST_ASSERT_NULL(out[2]);
+	TEST_ASSERT_EQUAL_PTR(te[0], out[3]);
+	TEST_ASSERT_EQUAL_PTR(te[1], out[4]);
+
+	/* Enumerate entries sharing a tag. */
+	TEST_ASSERT_EQUAL_PTR(te[0], it = transfer_list_find_next(tl, test_tag,
+								   NULL));
+	TEST_ASSERT_EQUAL_PTR(te[2], it = transfer_list_find_next(tl, test_tag,
+								   it));
+	TEST_ASSERT_NULL(transfer_list_find_next(tl, test_tag, it));
+	TEST_ASSERT_NULL(transfer_list_find_next(tl, test_tag + 1, te[1]));
+}
+
+void test_view()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_entry *te = NULL, *vte = NULL;
+	struct transfer_list_view view;
+	uint32_t count = 0;
+
+	TEST_ASSERT(transfer_list_add(tl, test_tag, 5, test_page_data));
+	TEST_ASSERT(transfer_list_add_with_align(tl, test_tag + 1, 0x20,
+						 test_page_data, 6));
+	TEST_ASSERT(transfer_list_add(tl, test_tag + 2, 0, NULL));
+
+	TEST_ASSERT_TRUE(transfer_list_view_open(&view, tl));
+	do {
+		te = transfer_list_next(tl, te);
+		vte = transfer_list_view_next(&view, vte);
+		TEST_ASSERT_EQUAL_PTR(te, vte);
+		count += te != NULL;
+	} while (te);
+	TEST_ASSERT_EQUAL(count, view.count);
+	TEST_ASSERT_EQUAL_PTR(transfer_list_find(tl, test_tag + 2),
+			      transfer_list_view_find(&view, test_tag + 2));
+	TEST_ASSERT_NULL(transfer_list_view_find(&view, test_tag + 3));
+
+	/* A malformed entry is rejected up front, even with a good checksum. */
+	te = transfer_list_find(tl, test_tag + 1);
+	te->hdr_size = 4;
+	transfer_list_update_checksum(tl);
+	TEST_ASSERT_FALSE(transfer_list_view_open(&view, tl));
+
+	te->hdr_size = sizeof(*te);
+	TEST_ASSERT_FALSE(transfer_list_view_open(&view, tl));
+	transfer_list_update_checksum(tl);
+	TEST_ASSERT_TRUE(transfer_list_view_open(&view, tl));
 }
 
 void setUp(void)
@@ -202,5 +811,17 @@ int main(void)
 	RUN_TEST(test_add_with_align);
 	RUN_TEST(test_rem);
 	RUN_TEST(test_set_data_size);
+	RUN_TEST(test_checksum_dirty_memory);
+	RUN_TEST(test_checksum_caller_fill);
+	RUN_TEST(test_batch);
+	RUN_TEST(test_iter);
+	RUN_TEST(test_add_many);
+	RUN_TEST(test_compact);
+	RUN_TEST(test_add_placed);
+	RUN_TEST(test_reserve_commit);
+	RUN_TEST(test_reserve_abort);
+	RUN_TEST(test_resize);
+	RUN_TEST(test_find_many);
+	RUN_TEST(test_view);
 	return UNITY_END();
 }
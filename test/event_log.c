@@ -0,0 +1,165 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "tpm_event_log.h"
+#include "transfer_list.h"
+#include "unity.h"
+
+#define EVENTS 200U
+#define EVENT_SIZE 40U
+
+void *buffer = NULL;
+
+static void log_events(struct transfer_list_event_log_writer *writer,
+		       uint32_t first, uint32_t count)
+{
+	uint8_t *event;
+
+	for (uint32_t i = first; i < first + count; i++) {
+		TEST_ASSERT(event = transfer_list_event_log_writer_extend(
+				    writer, EVENT_SIZE));
+		memset(event, i & 0xff, EVENT_SIZE);
+	}
+}
+
+static void check_events(const uint8_t *log, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		for (uint32_t j = 0; j < EVENT_SIZE; j++) {
+			TEST_ASSERT_EQUAL_UINT8(i & 0xff,
+						log[i * EVENT_SIZE + j]);
+		}
+	}
+}
+
+void test_event_log_writer()
+{
+	struct transfer_list_event_log_writer writer;
+	struct transfer_list_header *tl;
+	struct transfer_list_entry *te;
+	uint8_t *log;
+
+	TEST_ASSERT(tl = transfer_list_init(buffer, TL_MAX_SIZE));
+	TEST_ASSERT(transfer_list_add(tl, test_tag, sizeof(test_data),
+				      &test_data));
+
+	TEST_ASSERT_TRUE(transfer_list_event_log_writer_init(&writer, tl));
+	log_events(&writer, 0, EVENTS);
+	TEST_ASSERT(log = transfer_list_event_log_writer_finish(&writer));
+
+	/* The log is trimmed to what was written and the checksum valid. */
+	TEST_ASSERT(te = transfer_list_find(tl, TL_TAG_TPM_EVLOG));
+	TEST_ASSERT_EQUAL(EVENT_LOG_RESERVED_BYTES + EVENTS * EVENT_SIZE,
+			  te->data_size);
+	TEST_ASSERT_EQUAL_PTR((uint8_t *)transfer_list_entry_data(te) +
+				      EVENT_LOG_RESERVED_BYTES,
+			      log);
+	TEST_ASSERT_EQUAL(TL_OPS_ALL, transfer_list_check_header(tl));
+	check_events(log, EVENTS);
+
+	/* A new writer continues the existing log. */
+	TEST_ASSERT_TRUE(transfer_list_event_log_writer_init(&writer, tl));
+	log_events(&writer, EVENTS, EVENTS);
+	TEST_ASSERT(log = transfer_list_event_log_writer_finish(&writer));
+	TEST_ASSERT(te = transfer_list_find(tl, TL_TAG_TPM_EVLOG));
+	TEST_ASSERT_EQUAL(EVENT_LOG_RESERVED_BYTES + 2 * EVENTS * EVENT_SIZE,
+			  te->data_size);
+	TEST_ASSERT_EQUAL(TL_OPS_ALL, transfer_list_check_header(tl));
+	check_events(log, 2 * EVENTS);
+
+	/* The log cannot outgrow the list. */
+	TEST_ASSERT_TRUE(transfer_list_event_log_writer_init(&writer, tl));
+	TEST_ASSERT_NULL(
+		transfer_list_event_log_writer_extend(&writer, TL_MAX_SIZE));
+	TEST_ASSERT(transfer_list_event_log_writer_finish(&writer));
+	TEST_ASSERT_EQUAL(TL_OPS_ALL, transfer_list_check_header(tl));
+}
+
+void test_event_log_writer_batch()
+{
+	struct transfer_list_event_log_writer writer;
+	struct transfer_list_header *tl;
+	uint8_t *log;
+
+	TEST_ASSERT(tl = transfer_list_init(buffer, TL_MAX_SIZE));
+	TEST_ASSERT_FALSE(transfer_list_event_log_writer_init(&writer, NULL));
+
+	/* Finishing without logging anything leaves the list unchanged. */
+	TEST_ASSERT_TRUE(transfer_list_event_log_writer_init(&writer, tl));
+	TEST_ASSERT_NULL(transfer_list_event_log_writer_finish(&writer));
+	TEST_ASSERT_NULL(transfer_list_find(tl, TL_TAG_TPM_EVLOG));
+
+	/* The writer does not hold a batch session of its own. */
+	TEST_ASSERT_TRUE(transfer_list_event_log_writer_init(&writer, tl));
+	TEST_ASSERT_TRUE(transfer_list_batch_begin(tl));
+	TEST_ASSERT_TRUE(transfer_list_batch_commit(tl));
+
+	/* A writer can run inside a batch session of the caller. */
+	TEST_ASSERT_TRUE(transfer_list_batch_begin(tl));
+	log_events(&writer, 0, EVENTS);
+	TEST_ASSERT(log = transfer_list_event_log_writer_finish(&writer));
+	TEST_ASSERT_TRUE(transfer_list_batch_commit(tl));
+	TEST_ASSERT_EQUAL(TL_OPS_ALL, transfer_list_check_header(tl));
+	check_events(log, EVENTS);
+}
+
+void test_event_log_extend()
+{
+	struct transfer_list_header *tl;
+	struct transfer_list_entry *te;
+	uint8_t *event, *log;
+
+	TEST_ASSERT(tl = transfer_list_init(buffer, TL_MAX_SIZE));
+	TEST_ASSERT(transfer_list_add(tl, test_tag, sizeof(test_data),
+				      &test_data));
+
+	/*
+	 * Events written between the stateless calls are taken into the
+	 * checksum by the next call modifying the list, whatever it is.
+	 */
+	for (uint32_t i = 0; i < EVENTS; i++) {
+		TEST_ASSERT(event = transfer_list_event_log_extend(tl,
+								   EVENT_SIZE));
+		memset(event, i & 0xff, EVENT_SIZE);
+	}
+	TEST_ASSERT(transfer_list_add(tl, test_tag + 1, sizeof(test_data),
+				      &test_data));
+	TEST_ASSERT_EQUAL(TL_OPS_ALL, transfer_list_check_header(tl));
+
+	/* Finishing trims the space extended beyond the cursor. */
+	TEST_ASSERT(event = transfer_list_event_log_extend(tl, EVENT_SIZE));
+	TEST_ASSERT(log = transfer_list_event_log_finish(tl,
+							  (uintptr_t)event));
+	TEST_ASSERT(te = transfer_list_find(tl, TL_TAG_TPM_EVLOG));
+	TEST_ASSERT_EQUAL(EVENT_LOG_RESERVED_BYTES + EVENTS * EVENT_SIZE,
+			  te->data_size);
+	TEST_ASSERT_EQUAL(TL_OPS_ALL, transfer_list_check_header(tl));
+	check_events(log, EVENTS);
+}
+
+void setUp(void)
+{
+	buffer = malloc(TL_MAX_SIZE);
+}
+
+void tearDown(void)
+{
+	free(buffer);
+	buffer = NULL;
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_event_log_writer);
+	RUN_TEST(test_event_log_writer_batch);
+	RUN_TEST(test_event_log_extend);
+	return UNITY_END();
+}
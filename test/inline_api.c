@@ -0,0 +1,80 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+/* Use the static inline hot-path functions, as the LIBTL_INLINE option does */
+#if !defined(LIBTL_INLINE)
+#define LIBTL_INLINE
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "transfer_list.h"
+#include "unity.h"
+
+void *buffer = NULL;
+
+void test_inline_lookups()
+{
+	struct transfer_list_entry *te, *expected[10], *lib[10];
+	struct transfer_list_report report;
+	struct transfer_list_header *tl;
+	uint8_t payload[9 * 3];
+	uint32_t tags[10];
+	size_t n = 0;
+
+	memset(payload, 0x5a, sizeof(payload));
+	TEST_ASSERT(tl = transfer_list_init(buffer, TL_SIZE));
+	TEST_ASSERT(transfer_list_index_create(tl, 16));
+	for (uint32_t tag = 1; tag <= 9; tag++) {
+		TEST_ASSERT(transfer_list_add(tl, tag % 4 + 1, tag * 3,
+					      payload));
+	}
+	TEST_ASSERT(transfer_list_rem(tl, transfer_list_find(tl, 3)));
+
+	/* Walk with the inline functions, as the library walks. */
+	te = NULL;
+	while ((te = transfer_list_next(tl, te)) != NULL) {
+		TEST_ASSERT_EQUAL_PTR((uint8_t *)te + te->hdr_size,
+				      transfer_list_entry_data(te));
+		n++;
+	}
+	TEST_ASSERT_EQUAL(TL_OPS_ALL, transfer_list_validate(tl, &report));
+	TEST_ASSERT_EQUAL(report.entry_count, n);
+
+	/*
+	 * The inline find ignores the tag index and finds the same entries,
+	 * including the hole left by the removed entry.
+	 */
+	for (uint32_t i = 0; i < 10; i++) {
+		tags[i] = i;
+		expected[i] = transfer_list_find(tl, i);
+	}
+	transfer_list_find_many(tl, tags, 10, lib);
+	TEST_ASSERT_EQUAL_MEMORY(lib, expected, sizeof(lib));
+	TEST_ASSERT(expected[TL_TAG_EMPTY]);
+	TEST_ASSERT_NULL(transfer_list_entry_data(NULL));
+	TEST_ASSERT_NULL(transfer_list_next(NULL, NULL));
+}
+
+void setUp(void)
+{
+	buffer = malloc(TL_MAX_SIZE);
+}
+
+void tearDown(void)
+{
+	free(buffer);
+	buffer = NULL;
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_inline_lookups);
+	return UNITY_END();
+}
@@ -0,0 +1,234 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "transfer_list.h"
+#include "unity.h"
+
+#if defined(LIBTL_LOG_RING)
+#include "log_ring.h"
+#endif
+
+void *buffer = NULL;
+
+#if defined(LIBTL_LOG_RING)
+static char drained[8][256];
+static const char *drained_level[8];
+static uint64_t drained_ts[8];
+static size_t drained_count;
+static uint64_t clock_ticks;
+
+static uint64_t test_timestamp(void)
+{
+	return ++clock_ticks;
+}
+
+static void test_emit(const char *level, uint64_t timestamp, const char *msg)
+{
+	TEST_ASSERT(drained_count < 8);
+	drained_level[drained_count] = level;
+	drained_ts[drained_count] = timestamp;
+	snprintf(drained[drained_count], sizeof(drained[0]), "%s", msg);
+	drained_count++;
+}
+#endif
+
+/*
+ * The logger callbacks are called directly, bypassing the log level filtering
+ * of the info(), warn() and error() macros.
+ */
+void test_log_ring_format()
+{
+#if defined(LIBTL_LOG_RING)
+	struct libtl_log_ring ring;
+	uint64_t ring_buf[128];
+	char expected[256];
+	char str[16];
+
+	TEST_ASSERT_TRUE(libtl_log_ring_init(&ring, ring_buf, sizeof(ring_buf),
+					     test_timestamp));
+	libtl_log_ring_register(&ring);
+
+	/* Strings are copied, so later changes do not show up. */
+	strcpy(str, "entry");
+	(logger->info)("%s %d of %zu at %#x\n", str, -3, (size_t)7, 0x40U);
+	strcpy(str, "changed");
+	(logger->warn)("[%*d] %-5s|%.2s %% %llx\n", 6, 42, "ab", "xyz",
+		       0x123456789abcULL);
+	(logger->error)("no arguments\n");
+
+	TEST_ASSERT_EQUAL(3, libtl_log_ring_drain(&ring, test_emit));
+	TEST_ASSERT_EQUAL(3, drained_count);
+
+	snprintf(expected, sizeof(expected), "%s %d of %zu at %#x\n", "entry",
+		 -3, (size_t)7, 0x40U);
+	TEST_ASSERT_EQUAL_STRING(expected, drained[0]);
+	TEST_ASSERT_EQUAL_STRING("INFO", drained_level[0]);
+
+	snprintf(expected, sizeof(expected), "[%*d] %-5s|%.2s %% %llx\n", 6,
+		 42, "ab", "xyz", 0x123456789abcULL);
+	TEST_ASSERT_EQUAL_STRING(expected, drained[1]);
+	TEST_ASSERT_EQUAL_STRING("WARN", drained_level[1]);
+
+	TEST_ASSERT_EQUAL_STRING("no arguments\n", drained[2]);
+	TEST_ASSERT_EQUAL_STRING("ERROR", drained_level[2]);
+
+	/* Timestamps are taken when recording, not when draining. */
+	TEST_ASSERT(drained_ts[0] < drained_ts[1]);
+	TEST_ASSERT(drained_ts[1] < drained_ts[2]);
+
+	/* Messages from the library itself end up in the ring too. */
+	drained_count = 0;
+	TEST_ASSERT(transfer_list_init(buffer, TL_SIZE));
+	((struct transfer_list_header *)buffer)->signature = 0;
+	TEST_ASSERT_EQUAL(TL_OPS_NON,
+			  transfer_list_check_header(
+				  (struct transfer_list_header *)buffer));
+#if LIBTL_LOG_LEVEL >= LIBTL_LOG_LEVEL_WARN
+	TEST_ASSERT_EQUAL(1, libtl_log_ring_drain(&ring, test_emit));
+	TEST_ASSERT_EQUAL_STRING("Bad transfer list signature 0\n",
+				 drained[0]);
+#else
+	TEST_ASSERT_EQUAL(0, libtl_log_ring_drain(&ring, test_emit));
+#endif
+
+	libtl_register_logger(NULL);
+#else
+	/* built without LIBTL_LOG_RING */
+	TEST_IGNORE();
+#endif
+}
+
+void test_log_ring_wrap()
+{
+#if defined(LIBTL_LOG_RING)
+	struct libtl_log_ring ring;
+	uint64_t ring_buf[24];
+	char expected[32];
+
+	TEST_ASSERT_FALSE(libtl_log_ring_init(&ring, ring_buf, 8, NULL));
+	TEST_ASSERT_TRUE(libtl_log_ring_init(&ring, ring_buf, sizeof(ring_buf),
+					     NULL));
+	libtl_register_logger(NULL);
+	libtl_log_ring_register(&ring);
+
+	/*
+	 * Each record takes 32 bytes and the ring never fills up completely,
+	 * so only five fit; the rest are dropped until it is drained.
+	 */
+	for (int i = 0; i < 7; i++) {
+		(logger->info)("message %d\n", i);
+	}
+	drained_count = 0;
+	TEST_ASSERT_EQUAL(6, libtl_log_ring_drain(&ring, test_emit));
+	TEST_ASSERT_EQUAL_STRING("message 0\n", drained[0]);
+	TEST_ASSERT_EQUAL_STRING("message 4\n", drained[4]);
+	TEST_ASSERT_EQUAL_STRING("2 log messages dropped\n", drained[5]);
+	TEST_ASSERT_EQUAL_STRING("WARN", drained_level[5]);
+	TEST_ASSERT_EQUAL(0, drained_ts[0]);
+
+	/*
+	 * Records of varying size wrap around the end of the ring, at times
+	 * leaving its tail unused.
+	 */
+	for (int round = 0; round < 8; round++) {
+		(logger->info)("%s\n", "pad");
+		for (int i = 0; i < 3; i++) {
+			(logger->info)("message %d\n", round + i);
+		}
+		drained_count = 0;
+		TEST_ASSERT_EQUAL(4, libtl_log_ring_drain(&ring, test_emit));
+		TEST_ASSERT_EQUAL_STRING("pad\n", drained[0]);
+		for (int i = 0; i < 3; i++) {
+			snprintf(expected, sizeof(expected), "message %d\n",
+				 round + i);
+			TEST_ASSERT_EQUAL_STRING(expected, drained[i + 1]);
+		}
+	}
+
+	libtl_register_logger(NULL);
+#else
+	/* built without LIBTL_LOG_RING */
+	TEST_IGNORE();
+#endif
+}
+
+void test_log_ring_empty()
+{
+#if defined(LIBTL_LOG_RING)
+	struct libtl_log_ring ring;
+	uint64_t ring_buf[24];
+	char str[LIBTL_LOG_RING_MAX_STR + 1];
+	char expected[256];
+
+	memset(str, 'x', LIBTL_LOG_RING_MAX_STR);
+	str[LIBTL_LOG_RING_MAX_STR] = '\0';
+	snprintf(expected, sizeof(expected), "%s%s\n", str, str);
+
+	/*
+	 * Whichever record a drain ended on, the empty ring takes a record of
+	 * 176 bytes, the most a 192 byte ring holds, and then five more of 32
+	 * bytes, without dropping any of them.
+	 */
+	for (int start = 0; start < 6; start++) {
+		TEST_ASSERT_TRUE(libtl_log_ring_init(
+			&ring, ring_buf, sizeof(ring_buf), NULL));
+		libtl_register_logger(NULL);
+		libtl_log_ring_register(&ring);
+
+		for (int i = 0; i < start; i++) {
+			(logger->info)("message %d\n", i);
+		}
+		drained_count = 0;
+		TEST_ASSERT_EQUAL(start, libtl_log_ring_drain(&ring, test_emit));
+
+		(logger->info)("%s%s\n", str, str);
+		drained_count = 0;
+		TEST_ASSERT_EQUAL(1, libtl_log_ring_drain(&ring, test_emit));
+		TEST_ASSERT_EQUAL_STRING(expected, drained[0]);
+
+		for (int i = 0; i < 5; i++) {
+			(logger->info)("message %d\n", i);
+		}
+		drained_count = 0;
+		TEST_ASSERT_EQUAL(5, libtl_log_ring_drain(&ring, test_emit));
+		TEST_ASSERT_EQUAL_STRING("message 0\n", drained[0]);
+		TEST_ASSERT_EQUAL_STRING("message 4\n", drained[4]);
+	}
+
+	libtl_register_logger(NULL);
+#else
+	/* built without LIBTL_LOG_RING */
+	TEST_IGNORE();
+#endif
+}
+
+void setUp(void)
+{
+	buffer = malloc(TL_MAX_SIZE);
+#if defined(LIBTL_LOG_RING)
+	drained_count = 0;
+#endif
+}
+
+void tearDown(void)
+{
+	free(buffer);
+	buffer = NULL;
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_log_ring_format);
+	RUN_TEST(test_log_ring_wrap);
+	RUN_TEST(test_log_ring_empty);
+	return UNITY_END();
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "transfer_list.h"
+#include "unity.h"
+
+#if defined(LIBTL_PARALLEL)
+#include "transfer_list_parallel.h"
+#endif
+
+/* large enough for the checksum to be split across several threads */
+#define PARALLEL_TL_SIZE (8U << 20)
+
+void *buffer = NULL;
+
+void test_parallel_checksum()
+{
+#if defined(LIBTL_PARALLEL)
+	struct transfer_list_report serial, parallel;
+	struct transfer_list_header *tl;
+	struct transfer_list_entry *te;
+	const unsigned int threads[] = { 0, 1, 3, 8 };
+	uint32_t data_size = PARALLEL_TL_SIZE / 4;
+	uint8_t tail[0x123];
+
+	TEST_ASSERT(tl = transfer_list_init(buffer, PARALLEL_TL_SIZE));
+	for (uint32_t tag = 1; tag <= 3; tag++) {
+		TEST_ASSERT(te = transfer_list_add(tl, tag, data_size, NULL));
+		memset(transfer_list_entry_data(te), tag * 0x11, data_size);
+	}
+	memset(tail, 0x5a, sizeof(tail));
+	TEST_ASSERT(transfer_list_add(tl, 4, sizeof(tail), tail));
+	transfer_list_update_checksum(tl);
+
+	TEST_ASSERT_EQUAL(TL_OPS_ALL, transfer_list_validate(tl, &serial));
+	for (size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+		TEST_ASSERT_TRUE(
+			transfer_list_verify_checksum_parallel(tl, threads[i]));
+		TEST_ASSERT_EQUAL(TL_OPS_ALL,
+				  transfer_list_validate_parallel(
+					  tl, &parallel, threads[i]));
+		TEST_ASSERT_EQUAL_MEMORY(&serial, &parallel, sizeof(serial));
+	}
+
+	/* A corrupted byte near the end lands in the last thread's chunk. */
+	((uint8_t *)tl)[tl->size - 0x100]++;
+	for (size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+		TEST_ASSERT_FALSE(
+			transfer_list_verify_checksum_parallel(tl, threads[i]));
+		TEST_ASSERT_EQUAL(TL_OPS_NON,
+				  transfer_list_validate_parallel(
+					  tl, &parallel, threads[i]));
+		TEST_ASSERT_FALSE(parallel.checksum_ok);
+	}
+#else
+	/* built without LIBTL_PARALLEL */
+	TEST_IGNORE();
+#endif
+}
+
+void setUp(void)
+{
+	buffer = malloc(PARALLEL_TL_SIZE);
+}
+
+void tearDown(void)
+{
+	free(buffer);
+	buffer = NULL;
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_parallel_checksum);
+	return UNITY_END();
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "transfer_list.h"
+#include "unity.h"
+
+#if defined(LIBTL_SEQLOCK)
+#include "transfer_list_seqlock.h"
+#endif
+
+#define READERS 3
+#define WRITES 20000
+#define TARGET_TAG (test_tag + 1)
+
+void *buffer = NULL;
+
+#if defined(LIBTL_SEQLOCK)
+static struct transfer_list_header *shared_tl;
+static struct transfer_list_seqlock lock;
+static atomic_bool writer_done;
+static atomic_uint reader_errors;
+
+/*
+ * Resize the entry in front of the target, which moves the target, then
+ * resize the target and fill its data with the iteration number.
+ */
+static void *writer(void *arg)
+{
+	struct transfer_list_entry *front = arg, *te;
+
+	for (uint32_t i = 1; i <= WRITES; i++) {
+		transfer_list_write_begin(&lock);
+		transfer_list_set_data_size(shared_tl, front, (i % 32) * 8);
+		te = transfer_list_find(shared_tl, TARGET_TAG);
+		transfer_list_set_data_size(shared_tl, te, 16 + (i % 4) * 16);
+		memset(transfer_list_entry_data(te), i & 0xff, te->data_size);
+		transfer_list_update_checksum(shared_tl);
+		transfer_list_write_end(&lock);
+	}
+	atomic_store(&writer_done, true);
+
+	return NULL;
+}
+
+/*
+ * Every snapshot must show one complete write: a valid size and data filled
+ * with a single value.
+ */
+static void *reader(void *arg)
+{
+	uint8_t data[128];
+	uint32_t size;
+
+	(void)arg;
+	while (!atomic_load(&writer_done)) {
+		size = sizeof(data);
+		if (!transfer_list_read_find(shared_tl, &lock, TARGET_TAG,
+					     data, &size) ||
+		    size < 16 || size > 64 || size % 16 != 0) {
+			atomic_fetch_add(&reader_errors, 1);
+			continue;
+		}
+		for (uint32_t i = 1; i < size; i++) {
+			if (data[i] != data[0]) {
+				atomic_fetch_add(&reader_errors, 1);
+				break;
+			}
+		}
+	}
+
+	return NULL;
+}
+#endif
+
+void test_read_find()
+{
+#if defined(LIBTL_SEQLOCK)
+	struct transfer_list_header *tl;
+	struct transfer_list_entry *te;
+	uint8_t data[8];
+	uint32_t size;
+
+	TEST_ASSERT(tl = transfer_list_init(buffer, TL_SIZE));
+	transfer_list_seqlock_init(&lock);
+
+	TEST_ASSERT(te = transfer_list_add(tl, test_tag, 16, NULL));
+	memset(transfer_list_entry_data(te), 0x5a, 16);
+	transfer_list_update_checksum(tl);
+
+	/* The data is truncated to the buffer, the full size reported. */
+	size = sizeof(data);
+	TEST_ASSERT_TRUE(
+		transfer_list_read_find(tl, &lock, test_tag, data, &size));
+	TEST_ASSERT_EQUAL(16, size);
+	TEST_ASSERT_EQUAL_UINT8(0x5a, data[sizeof(data) - 1]);
+
+	size = 0;
+	TEST_ASSERT_TRUE(
+		transfer_list_read_find(tl, &lock, test_tag, NULL, &size));
+	TEST_ASSERT_EQUAL(16, size);
+
+	size = sizeof(data);
+	TEST_ASSERT_FALSE(
+		transfer_list_read_find(tl, &lock, TARGET_TAG, data, &size));
+	TEST_ASSERT_EQUAL(sizeof(data), size);
+
+	/* A corrupted size does not make the walk leave the list. */
+	te->data_size = TL_SIZE;
+	TEST_ASSERT_FALSE(
+		transfer_list_read_find(tl, &lock, TARGET_TAG, data, &size));
+#else
+	/* built without LIBTL_SEQLOCK */
+	TEST_IGNORE();
+#endif
+}
+
+void test_concurrent_read_find()
+{
+#if defined(LIBTL_SEQLOCK)
+	pthread_t readers[READERS], writer_thread;
+	struct transfer_list_entry *front;
+
+	TEST_ASSERT(shared_tl = transfer_list_init(buffer, TL_SIZE));
+	transfer_list_seqlock_init(&lock);
+	atomic_store(&writer_done, false);
+	atomic_store(&reader_errors, 0);
+
+	TEST_ASSERT(front = transfer_list_add(shared_tl, test_tag, 0, NULL));
+	TEST_ASSERT(transfer_list_add(shared_tl, TARGET_TAG, 16, NULL));
+
+	for (int i = 0; i < READERS; i++) {
+		TEST_ASSERT_EQUAL(0, pthread_create(&readers[i], NULL, reader,
+						    NULL));
+	}
+	TEST_ASSERT_EQUAL(0, pthread_create(&writer_thread, NULL, writer,
+					    front));
+
+	pthread_join(writer_thread, NULL);
+	for (int i = 0; i < READERS; i++) {
+		pthread_join(readers[i], NULL);
+	}
+
+	TEST_ASSERT_EQUAL(0, atomic_load(&reader_errors));
+	TEST_ASSERT_EQUAL(WRITES * 2, atomic_load(&lock.seq));
+	TEST_ASSERT(transfer_list_verify_checksum(shared_tl));
+#else
+	/* built without LIBTL_SEQLOCK */
+	TEST_IGNORE();
+#endif
+}
+
+void setUp(void)
+{
+	buffer = malloc(TL_MAX_SIZE);
+}
+
+void tearDown(void)
+{
+	free(buffer);
+	buffer = NULL;
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_read_find);
+	RUN_TEST(test_concurrent_read_find);
+	return UNITY_END();
+}
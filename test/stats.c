@@ -0,0 +1,125 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "transfer_list.h"
+#include "unity.h"
+
+void *buffer = NULL;
+
+#if defined(LIBTL_PARALLEL)
+#define THREADS 4
+#define VERIFIES 20000
+
+static void *verify_worker(void *arg)
+{
+	for (int i = 0; i < VERIFIES; i++) {
+		transfer_list_verify_checksum(arg);
+	}
+
+	return NULL;
+}
+#endif
+
+void test_stats()
+{
+	struct transfer_list_header *tl;
+	struct transfer_list_entry *te;
+	struct transfer_list_stats stats;
+	uint8_t payload[0x10];
+
+	transfer_list_stats_reset();
+	if (!transfer_list_stats_get(&stats)) {
+		/* built without LIBTL_STATS */
+		TEST_ASSERT_EQUAL(0, stats.bytes_summed);
+		TEST_IGNORE();
+	}
+
+	memset(payload, 0x5a, sizeof(payload));
+	TEST_ASSERT(tl = transfer_list_init(buffer, TL_SIZE));
+	TEST_ASSERT(te = transfer_list_add(tl, test_tag, 0x10, NULL));
+	TEST_ASSERT(transfer_list_add_with_align(tl, test_tag + 1, 0x10,
+						 payload, 6));
+
+	TEST_ASSERT_TRUE(transfer_list_stats_get(&stats));
+	TEST_ASSERT_EQUAL(1, stats.calls[TL_STAT_INIT]);
+	TEST_ASSERT_EQUAL(1, stats.calls[TL_STAT_ADD]);
+	TEST_ASSERT_EQUAL(1, stats.calls[TL_STAT_ADD_WITH_ALIGN]);
+	TEST_ASSERT_EQUAL(1, stats.dummy_entries);
+	TEST_ASSERT(stats.bytes_summed >= sizeof(*tl));
+
+	/* Growing the first entry moves the ones behind it. */
+	transfer_list_stats_reset();
+	TEST_ASSERT(transfer_list_set_data_size(tl, te, 0x100));
+	TEST_ASSERT_TRUE(transfer_list_stats_get(&stats));
+	TEST_ASSERT_EQUAL(1, stats.calls[TL_STAT_SET_DATA_SIZE]);
+	TEST_ASSERT(stats.bytes_moved > 0);
+	TEST_ASSERT(stats.entries_stepped > 0);
+
+	transfer_list_stats_reset();
+	TEST_ASSERT_TRUE(transfer_list_stats_get(&stats));
+	TEST_ASSERT_EQUAL(0, stats.calls[TL_STAT_SET_DATA_SIZE]);
+	TEST_ASSERT_EQUAL(0, stats.bytes_moved);
+}
+
+void test_stats_threads()
+{
+#if defined(LIBTL_PARALLEL)
+	struct transfer_list_header *tl;
+	struct transfer_list_stats stats;
+	pthread_t threads[THREADS];
+
+	transfer_list_stats_reset();
+	if (!transfer_list_stats_get(&stats)) {
+		/* built without LIBTL_STATS */
+		TEST_IGNORE();
+	}
+
+	/* No update is lost when the library is used from several threads. */
+	TEST_ASSERT(tl = transfer_list_init(buffer, TL_SIZE));
+	transfer_list_stats_reset();
+	for (int i = 0; i < THREADS; i++) {
+		TEST_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL,
+						    verify_worker, tl));
+	}
+	for (int i = 0; i < THREADS; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	TEST_ASSERT_TRUE(transfer_list_stats_get(&stats));
+	TEST_ASSERT_EQUAL(THREADS * VERIFIES,
+			  stats.calls[TL_STAT_VERIFY_CHECKSUM]);
+	TEST_ASSERT_EQUAL(THREADS * VERIFIES * (uint64_t)tl->size,
+			  stats.bytes_summed);
+#else
+	/* built without LIBTL_PARALLEL, the counters are not thread safe */
+	TEST_IGNORE();
+#endif
+}
+
+void setUp(void)
+{
+	buffer = malloc(TL_MAX_SIZE);
+}
+
+void tearDown(void)
+{
+	free(buffer);
+	buffer = NULL;
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_stats);
+	RUN_TEST(test_stats_threads);
+	return UNITY_END();
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "transfer_list.h"
+#include "unity.h"
+
+void *buffer = NULL;
+
+static struct transfer_list_entry *walk_find(struct transfer_list_header *tl,
+					     uint32_t tag_id)
+{
+	struct transfer_list_entry *te = NULL;
+
+	while ((te = transfer_list_next(tl, te))) {
+		if (te->tag_id == tag_id) {
+			break;
+		}
+	}
+
+	return te;
+}
+
+static struct transfer_list_index *get_index(struct transfer_list_header *tl)
+{
+	struct transfer_list_entry *te = transfer_list_next(tl, NULL);
+
+	TEST_ASSERT_NOT_NULL(te);
+	TEST_ASSERT_EQUAL(TL_TAG_LIBTL_INDEX, te->tag_id);
+	return transfer_list_entry_data(te);
+}
+
+static void check_lookups(struct transfer_list_header *tl, uint32_t max_tag)
+{
+	struct transfer_list_entry *out[16], *te, *next;
+	uint32_t tags[16];
+
+	for (uint32_t tag = 1; tag <= max_tag; tag++) {
+		TEST_ASSERT_EQUAL_PTR(walk_find(tl, tag),
+				      transfer_list_find(tl, tag));
+		tags[tag - 1] = tag;
+
+		/* Duplicates are enumerated in list order. */
+		te = NULL;
+		while ((te = transfer_list_next(tl, te))) {
+			if (te->tag_id != tag) {
+				continue;
+			}
+			next = te;
+			while ((next = transfer_list_next(tl, next))) {
+				if (next->tag_id == tag) {
+					break;
+				}
+			}
+			TEST_ASSERT_EQUAL_PTR(next, transfer_list_find_next(
+							    tl, tag, te));
+		}
+	}
+
+	transfer_list_find_many(tl, tags, max_tag, out);
+	for (uint32_t tag = 1; tag <= max_tag; tag++) {
+		TEST_ASSERT_EQUAL_PTR(walk_find(tl, tag), out[tag - 1]);
+	}
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+}
+
+void test_index_create()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_entry *te;
+	int *data;
+
+	TEST_ASSERT(transfer_list_add(tl, 2, sizeof(test_data), &test_data));
+	TEST_ASSERT(transfer_list_add_with_align(tl, 1, sizeof(test_data),
+						 &test_data, 6));
+
+	/* Existing entries are moved behind the index, keeping alignment. */
+	TEST_ASSERT(transfer_list_index_create(tl, 8));
+	TEST_ASSERT_EQUAL(2, get_index(tl)->count);
+	TEST_ASSERT_EQUAL(tl->size, get_index(tl)->tl_size);
+	TEST_ASSERT(te = transfer_list_find(tl, 1));
+	TEST_ASSERT(data = transfer_list_entry_data(te));
+	TEST_ASSERT_FALSE((uintptr_t)data % (1 << 6));
+	TEST_ASSERT_EQUAL(test_data, *data);
+	check_lookups(tl, 3);
+
+	/* Creating it again just rebuilds it. */
+	TEST_ASSERT(transfer_list_index_create(tl, 8) ==
+		    transfer_list_next(tl, NULL));
+	TEST_ASSERT_EQUAL(2, get_index(tl)->count);
+}
+
+void test_index_maintenance()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_entry *te;
+	uint8_t payload[0x20];
+
+	memset(payload, 0x5a, sizeof(payload));
+	TEST_ASSERT(transfer_list_index_create(tl, 16));
+
+	/* Duplicate tags resolve to the first entry, like a walk. */
+	for (uint32_t i = 0; i < 8; i++) {
+		TEST_ASSERT(transfer_list_add(tl, 8 - (i % 4), 0x10 + i,
+					      payload));
+		check_lookups(tl, 9);
+	}
+	TEST_ASSERT_EQUAL(8, get_index(tl)->count);
+
+	/* Growing an early entry moves everything behind it. */
+	TEST_ASSERT(te = transfer_list_find(tl, 7));
+	TEST_ASSERT(transfer_list_set_data_size(tl, te, 0x100));
+	check_lookups(tl, 9);
+
+	TEST_ASSERT(te = transfer_list_find(tl, 6));
+	TEST_ASSERT(transfer_list_rem(tl, te));
+	TEST_ASSERT_EQUAL(7, get_index(tl)->count);
+	check_lookups(tl, 9);
+
+	TEST_ASSERT(te = transfer_list_find(tl, 6));
+	TEST_ASSERT(transfer_list_set_data_size(tl, te, 0x200));
+	TEST_ASSERT(transfer_list_rem(tl, transfer_list_find(tl, 8)));
+	check_lookups(tl, 9);
+
+	/* An entry placed into a hole comes before others with its tag. */
+	TEST_ASSERT(te = transfer_list_add_placed(tl, 5, 4, &test_data, 0,
+						  TL_PLACE_FIRST_FIT));
+	TEST_ASSERT_EQUAL_PTR(te, transfer_list_find(tl, 5));
+	check_lookups(tl, 9);
+	TEST_ASSERT_EQUAL(tl->size, get_index(tl)->tl_size);
+
+	struct transfer_list_entry_desc descs[] = {
+		{ .tag_id = 9, .data_size = 4, .data = &test_data },
+		{ .tag_id = 2, .data_size = 4, .data = NULL, .alignment = 5 },
+	};
+
+	TEST_ASSERT_TRUE(transfer_list_add_many(tl, descs, 2));
+	TEST_ASSERT_EQUAL(tl->size, get_index(tl)->tl_size);
+	check_lookups(tl, 10);
+
+	/* Resizing the last entry only moves the end of the list. */
+	TEST_ASSERT(te = transfer_list_find(tl, 2));
+	TEST_ASSERT_NULL(transfer_list_next(tl, te));
+	TEST_ASSERT(transfer_list_set_data_size(tl, te, 0x30));
+	TEST_ASSERT_EQUAL(tl->size, get_index(tl)->tl_size);
+	TEST_ASSERT_EQUAL_PTR(te, transfer_list_find(tl, 2));
+	check_lookups(tl, 10);
+	TEST_ASSERT(transfer_list_set_data_size(tl, te, 4));
+	TEST_ASSERT_EQUAL(tl->size, get_index(tl)->tl_size);
+	check_lookups(tl, 10);
+
+	TEST_ASSERT(transfer_list_compact(tl) > 0);
+	TEST_ASSERT_EQUAL(tl->size, get_index(tl)->tl_size);
+	check_lookups(tl, 10);
+}
+
+void test_index_stale()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_header *new_tl;
+	void *new_buf = malloc(TL_SIZE);
+	uint8_t payload[0x10];
+
+	memset(payload, 0x5a, sizeof(payload));
+	TEST_ASSERT(transfer_list_index_create(tl, 2));
+	for (uint32_t i = 1; i <= 4; i++) {
+		TEST_ASSERT(transfer_list_add(tl, i, 0x10, payload));
+	}
+
+	/* The index ran out of capacity, lookups walk the list. */
+	TEST_ASSERT(get_index(tl)->tl_size != tl->size);
+	check_lookups(tl, 5);
+	TEST_ASSERT_FALSE(transfer_list_index_rebuild(tl));
+
+	TEST_ASSERT(transfer_list_rem(tl, transfer_list_find(tl, 1)));
+	TEST_ASSERT(transfer_list_rem(tl, transfer_list_find(tl, 3)));
+	TEST_ASSERT_TRUE(transfer_list_index_rebuild(tl));
+	TEST_ASSERT_EQUAL(2, get_index(tl)->count);
+	check_lookups(tl, 5);
+
+	/* Offsets are relative, so the index survives a relocation. */
+	TEST_ASSERT(new_tl = transfer_list_relocate(tl, new_buf, TL_SIZE));
+	TEST_ASSERT_EQUAL(new_tl->size, get_index(new_tl)->tl_size);
+	check_lookups(new_tl, 5);
+
+	/* Removing the index falls back to walking the list. */
+	TEST_ASSERT(
+		transfer_list_rem(new_tl, transfer_list_next(new_tl, NULL)));
+	check_lookups(new_tl, 5);
+
+	free(new_buf);
+}
+
+void setUp(void)
+{
+	buffer = malloc(TL_MAX_SIZE);
+}
+
+void tearDown(void)
+{
+	free(buffer);
+	buffer = NULL;
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_index_create);
+	RUN_TEST(test_index_maintenance);
+	RUN_TEST(test_index_stale);
+	return UNITY_END();
+}
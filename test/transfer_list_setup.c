@@ -100,6 +100,156 @@ void test_bad_reloc()
 	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
 }
 
+static struct transfer_list_header *build_holey_list(void *addr)
+{
+	struct transfer_list_header *tl = transfer_list_init(addr, TL_SIZE);
+	struct transfer_list_entry *te;
+	uint8_t data[0x200];
+
+	for (uint32_t tag = 1; tag <= 5; tag++) {
+		memset(data, tag, sizeof(data));
+		TEST_ASSERT(te = transfer_list_add_with_align(
+				    tl, tag, 0x40 * tag, data,
+				    tag == 3 ? 8 : 0));
+	}
+	TEST_ASSERT(transfer_list_rem(tl, transfer_list_find(tl, 2)));
+	TEST_ASSERT(transfer_list_rem(tl, transfer_list_find(tl, 4)));
+
+	return tl;
+}
+
+static void check_compacted(struct transfer_list_header *tl,
+			    uint32_t old_size)
+{
+	struct transfer_list_entry *te = NULL;
+	uint32_t tags[] = { 1, 3, 5 }, i = 0;
+	uint8_t *data;
+
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+	TEST_ASSERT(tl->size < old_size);
+
+	while ((te = transfer_list_next(tl, te))) {
+		if (te->tag_id == TL_TAG_EMPTY) {
+			continue;
+		}
+		TEST_ASSERT(i < 3);
+		TEST_ASSERT_EQUAL(tags[i], te->tag_id);
+		TEST_ASSERT_EQUAL(0x40 * tags[i], te->data_size);
+		data = transfer_list_entry_data(te);
+		for (uint32_t n = 0; n < te->data_size; n++) {
+			TEST_ASSERT_EQUAL(tags[i], data[n]);
+		}
+		i++;
+	}
+	TEST_ASSERT_EQUAL(3, i);
+
+	te = transfer_list_find(tl, 3);
+	TEST_ASSERT_FALSE((uintptr_t)transfer_list_entry_data(te) % (1 << 8));
+}
+
+void test_relocate_compact()
+{
+	struct transfer_list_header *tl, *new_tl;
+	uint8_t *base = buffer;
+	uint32_t size;
+
+	/* To a separate region. */
+	tl = build_holey_list(base);
+	size = tl->size;
+	TEST_ASSERT(new_tl = transfer_list_relocate_compact(
+			    tl, base + 2 * TL_SIZE, TL_SIZE));
+	check_compacted(new_tl, size);
+
+	/* Too small a region leaves the original list intact. */
+	TEST_ASSERT_NULL(transfer_list_relocate_compact(tl, base + 2 * TL_SIZE,
+							0x100));
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+	TEST_ASSERT_EQUAL(size, tl->size);
+
+	/* Overlapping, moving down and moving up. */
+	tl = build_holey_list(base + TL_SIZE);
+	TEST_ASSERT(new_tl = transfer_list_relocate_compact(
+			    tl, base + TL_SIZE - 0x100, TL_SIZE));
+	check_compacted(new_tl, size);
+
+	tl = build_holey_list(base + TL_SIZE);
+	TEST_ASSERT(new_tl = transfer_list_relocate_compact(
+			    tl, base + TL_SIZE + 0x100, TL_SIZE));
+	check_compacted(new_tl, size);
+}
+
+void test_relocate_compact_padding()
+{
+	struct transfer_list_header *tl, *new_tl;
+	struct transfer_list_entry *te;
+	uint8_t *base = buffer, *dst = base + 2 * TL_SIZE;
+	uint8_t data[0x40];
+
+	/* Odd data sizes leave padding behind every entry. */
+	tl = transfer_list_init(base, TL_SIZE);
+	for (uint32_t tag = 1; tag <= 6; tag++) {
+		memset(data, tag, sizeof(data));
+		TEST_ASSERT(transfer_list_add(tl, tag, 0x7 * tag, data));
+	}
+	TEST_ASSERT(transfer_list_rem(tl, transfer_list_find(tl, 2)));
+	TEST_ASSERT(transfer_list_rem(tl, transfer_list_find(tl, 5)));
+
+	/* The padding at a dirty destination is accounted for. */
+	memset(dst, 0xff, TL_SIZE);
+	TEST_ASSERT(new_tl = transfer_list_relocate_compact(tl, dst, TL_SIZE));
+	TEST_ASSERT(transfer_list_check_header(new_tl) == TL_OPS_ALL);
+	TEST_ASSERT_NULL(transfer_list_find(new_tl, 2));
+	TEST_ASSERT(te = transfer_list_find(new_tl, 6));
+	TEST_ASSERT_EQUAL(0x7 * 6, te->data_size);
+	TEST_ASSERT_EQUAL_UINT8(6, ((uint8_t *)transfer_list_entry_data(
+					   te))[0x7 * 6 - 1]);
+
+	/* A corrupt source is not given a fresh checksum. */
+	te = transfer_list_find(tl, 3);
+	((uint8_t *)transfer_list_entry_data(te))[0]++;
+	memset(dst, 0xff, TL_SIZE);
+	TEST_ASSERT_NULL(transfer_list_relocate_compact(tl, dst, TL_SIZE));
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_NON);
+}
+
+void test_validate()
+{
+	struct transfer_list_header *tl = transfer_list_init(buffer, TL_SIZE);
+	struct transfer_list_entry *te;
+	struct transfer_list_report report;
+	uint32_t off;
+
+	TEST_ASSERT(transfer_list_add(tl, test_tag, sizeof(test_data),
+				      &test_data));
+	TEST_ASSERT(te = transfer_list_add(tl, test_tag + 1, 0x20, NULL));
+	TEST_ASSERT(transfer_list_add_with_align(tl, test_tag + 2,
+						 sizeof(test_data), &test_data,
+						 8));
+	TEST_ASSERT(transfer_list_rem(tl, te));
+
+	TEST_ASSERT(transfer_list_validate(tl, &report) == TL_OPS_ALL);
+	TEST_ASSERT_TRUE(report.checksum_ok);
+	TEST_ASSERT_EQUAL(0, report.bad_offset);
+	TEST_ASSERT(report.entry_count >= 3);
+	TEST_ASSERT(report.empty_bytes >= 0x28);
+	TEST_ASSERT(report.max_alignment >= 8);
+
+	/* An entry running past the end of the list is caught up front. */
+	te = transfer_list_find(tl, test_tag + 2);
+	off = (uintptr_t)te - (uintptr_t)tl;
+	te->data_size = TL_SIZE;
+	transfer_list_update_checksum(tl);
+	TEST_ASSERT(transfer_list_check_header(tl) == TL_OPS_ALL);
+	TEST_ASSERT(transfer_list_validate(tl, &report) == TL_OPS_NON);
+	TEST_ASSERT_TRUE(report.checksum_ok);
+	TEST_ASSERT_EQUAL(off, report.bad_offset);
+
+	te->data_size = sizeof(test_data);
+	TEST_ASSERT(transfer_list_validate(tl, &report) == TL_OPS_NON);
+	TEST_ASSERT_FALSE(report.checksum_ok);
+	TEST_ASSERT_EQUAL(0, report.bad_offset);
+}
+
 void setUp(void)
 {
 	buffer = malloc(TL_MAX_SIZE);
@@ -118,5 +268,8 @@ int main(void)
 	RUN_TEST(test_init_alignment);
 	RUN_TEST(test_init);
 	RUN_TEST(test_relocate);
+	RUN_TEST(test_relocate_compact);
+	RUN_TEST(test_relocate_compact_padding);
+	RUN_TEST(test_validate);
 	return UNITY_END();
 }
@@ -0,0 +1,73 @@
+/*
+ * Copyright The Transfer List Library Contributors
+ *
+ * SPDX-License-Identifier: MIT OR GPL-2.0-or-later
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "transfer_list.h"
+#include "transfer_list_typed.h"
+#include "unity.h"
+
+void *buffer = NULL;
+
+void test_typed_get()
+{
+	struct transfer_list_sram_layout64 sram = { 0x80000000, 0x10000 };
+	struct transfer_list_mbedtls_heap_info heap = { 0x90000000, 0x2000 };
+	struct transfer_list_sram_layout64 *sram_te;
+	struct transfer_list_mbedtls_heap_info *heap_te;
+	struct transfer_list_header *tl;
+
+	TEST_ASSERT(tl = transfer_list_init(buffer, TL_SIZE));
+	TEST_ASSERT_NULL(TL_GET(tl, TL_TAG_SRAM_LAYOUT64,
+				struct transfer_list_sram_layout64));
+
+	TEST_ASSERT(transfer_list_add(tl, TL_TAG_SRAM_LAYOUT64, sizeof(sram),
+				      &sram));
+	TEST_ASSERT(transfer_list_add(tl, TL_TAG_MBEDTLS_HEAP_INFO,
+				      sizeof(heap), &heap));
+
+	TEST_ASSERT(sram_te = TL_GET(tl, TL_TAG_SRAM_LAYOUT64,
+				     struct transfer_list_sram_layout64));
+	TEST_ASSERT_EQUAL_PTR(transfer_list_entry_data(transfer_list_find(
+				      tl, TL_TAG_SRAM_LAYOUT64)),
+			      sram_te);
+	TEST_ASSERT_EQUAL(sram.addr, sram_te->addr);
+	TEST_ASSERT_EQUAL(sram.size, sram_te->size);
+
+	TEST_ASSERT(heap_te = TL_GET(tl, TL_TAG_MBEDTLS_HEAP_INFO,
+				     struct transfer_list_mbedtls_heap_info));
+	TEST_ASSERT_EQUAL(heap.heap_addr, heap_te->heap_addr);
+	TEST_ASSERT_EQUAL(heap.heap_size, heap_te->heap_size);
+
+	/* Entries too small for their payload type are not returned. */
+	TEST_ASSERT(transfer_list_add(tl, TL_TAG_SRAM_LAYOUT32, 4, &test_data));
+	TEST_ASSERT_NULL(TL_GET(tl, TL_TAG_SRAM_LAYOUT32,
+				struct transfer_list_sram_layout32));
+
+	/* The payload must also be aligned for its type. */
+	TEST_ASSERT_NULL(transfer_list_get_payload(tl, TL_TAG_SRAM_LAYOUT64,
+						   sizeof(sram), 0x1000));
+}
+
+void setUp(void)
+{
+	buffer = malloc(TL_MAX_SIZE);
+}
+
+void tearDown(void)
+{
+	free(buffer);
+	buffer = NULL;
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_typed_get);
+	return UNITY_END();
+}
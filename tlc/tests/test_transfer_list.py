@@ -137,6 +137,51 @@ def test_calc_tl_checksum(tmpdir, random_entries):
     assert sum(tl_file.read_binary()) % 256 == 0
 
 
+def reference_checksum(tl):
+    """Checksum computed by serializing the whole TL."""
+    return (256 - (sum(tl.to_bytes()) - tl.checksum)) % 256
+
+
+def test_incremental_checksum(random_entries):
+    tl = TransferList(0x10000)
+    tags = []
+
+    for id, data in random_entries(20):
+        tl.add_transfer_entry(id % 4, data)
+        assert tl.checksum == reference_checksum(tl)
+
+    # Remove tags with entries of all sizes, and one that is not in the list.
+    for tag in (0, 2, 5):
+        tl.remove_tag(tag)
+        assert tl.checksum == reference_checksum(tl)
+        assert sum(tl.to_bytes()) % 256 == 0
+
+    assert all(te.id in (1, 3) for te in tl.entries)
+
+
+def test_incremental_checksum_from_file(tmpdir, random_entries):
+    test_file = tmpdir.join("test_tl_blob.bin")
+    original_tl = TransferList(0x10000)
+
+    for id, data in random_entries(10):
+        original_tl.add_transfer_entry(id % 4, data)
+
+    original_tl.write_to_file(test_file)
+
+    tl = TransferList.fromfile(test_file)
+    tl.remove_tag(1)
+    assert tl.checksum == reference_checksum(tl)
+
+    tl.add_transfer_entry(1, bytes(range(100)))
+    assert tl.checksum == reference_checksum(tl)
+
+    # The size of the list must still match its contents once written out.
+    tl.write_to_file(test_file)
+    blob_tl = TransferList.fromfile(test_file)
+    assert blob_tl.to_bytes() == tl.to_bytes()
+    assert sum(test_file.read_binary()) % 256 == 0
+
+
 def test_empty_transfer_list_blob(tmpdir):
     """Check that we can correctly create a transfer list header."""
     test_file = tmpdir.join("test_tl_blob.bin")
@@ -253,6 +298,69 @@ def test_read_multiple_transfer_list_from_file(tmpdir):
     assert tl.sum_of_bytes() == 0
 
 
+def test_read_transfer_list_without_copy(tmpdir):
+    test_file = tmpdir.join("test_tl_blob.bin")
+    original_tl = TransferList(0x1000)
+
+    for tag_id, data in test_entries:
+        original_tl.add_transfer_entry(tag_id, data)
+
+    original_tl.write_to_file(test_file)
+
+    # The data of each TE is a view of the file contents, not a copy.
+    tl = TransferList.fromfile(test_file)
+    assert len(tl.entries) == len(original_tl.entries)
+
+    for te0, te1 in zip(tl.entries, original_tl.entries):
+        assert isinstance(te0.data, memoryview)
+        assert te0.data == te1.data
+        assert te0.offset == te1.offset
+
+    assert tl.to_bytes() == original_tl.to_bytes()
+
+
+def test_read_transfer_list_header_only(tmpdir):
+    test_file = tmpdir.join("test_tl_blob.bin")
+    original_tl = TransferList(0x1000)
+
+    for tag_id, data in test_entries:
+        original_tl.add_transfer_entry(tag_id, data)
+
+    original_tl.write_to_file(test_file)
+
+    tl = TransferList.fromfile(test_file, header_only=True)
+    assert not tl.entries
+    assert tl.header_to_bytes() == original_tl.header_to_bytes()
+
+
+def test_read_truncated_transfer_list(tmpdir):
+    test_file = tmpdir.join("test_tl_blob.bin")
+    original_tl = TransferList(0x1000)
+    original_tl.add_transfer_entry(1, large_data)
+    test_file.write_binary(original_tl.to_bytes()[:-1])
+
+    with pytest.raises(ValueError):
+        TransferList.fromfile(test_file)
+
+
+def test_write_transfer_list_to_source_file(tmpdir):
+    test_file = tmpdir.join("test_tl_blob.bin")
+    original_tl = TransferList(0x1000)
+
+    for tag_id, data in test_entries:
+        original_tl.add_transfer_entry(tag_id, data)
+
+    original_tl.write_to_file(test_file)
+    blob = test_file.read_binary()
+
+    # The data read from the file must be copied before it is overwritten.
+    tl = TransferList.fromfile(test_file)
+    tl.write_to_file(test_file)
+
+    assert test_file.read_binary() == blob
+    assert all(isinstance(te.data, bytes) for te in tl.entries)
+
+
 def test_remove_tag(random_entry):
     """Adds a transfer entry and remove it, size == transfer list header."""
     tl = TransferList(0x100)
@@ -106,7 +106,10 @@ def info(filename, fdt_offset, header, entries):
     representing a transfer list (TL). The transfer list must comply with the
     version of the firmware handoff specification supported by this tool.
     """
-    tl = TransferList.fromfile(filename)
+    # Only the header needs to be read to print it.
+    tl = TransferList.fromfile(
+        filename, header_only=header and not (entries or fdt_offset)
+    )
 
     if fdt_offset:
         return print(tl.get_entry_data_offset(1))
@@ -8,7 +8,7 @@
 
 """Module containing definitions pertaining to the 'Transfer Entry' (TE) type."""
 
-from typing import ClassVar
+from typing import ClassVar, Union
 
 import struct
 from dataclasses import dataclass
@@ -20,7 +20,7 @@ class TransferEntry:
 
     id: int
     data_size: int
-    data: bytes
+    data: Union[bytes, memoryview]
     hdr_size: int = 8
     offset: int = 0
     # Header encoding, with little-endian byte order.
@@ -38,7 +38,7 @@ class TransferEntry:
             [
                 f"{k:<10} {hex(v)}"
                 for k, v in vars(self).items()
-                if not isinstance(v, bytes)
+                if not isinstance(v, (bytes, memoryview))
             ]
         )
 
@@ -48,7 +48,7 @@ class TransferEntry:
 
     @property
     def sum_of_bytes(self) -> int:
-        return sum(self.to_bytes()) % 256
+        return (sum(self.header_to_bytes()) + sum(self.data)) % 256
 
     def to_bytes(self) -> bytes:
         return self.header_to_bytes() + self.data
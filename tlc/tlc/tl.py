@@ -10,7 +10,9 @@
 
 from typing import Any, Dict, List, Optional
 
+import io
 import math
+import mmap
 import struct
 from dataclasses import dataclass
 from functools import reduce
@@ -97,7 +99,15 @@ class TransferList:
         self.size = self.hdr_size
         self.total_size = max_size
         self.flags = flags
-        self.entries: List[TransferEntry] = []
+        # Entries in list order, keyed by id() so that they can be removed in
+        # constant time, and indexed by tag.
+        self._entries: Dict[int, TransferEntry] = {}
+        self._tags: Dict[int, Dict[int, TransferEntry]] = {}
+        # Byte sum of each entry and of all of them, modulo 256. None until
+        # first needed for lists read from a file, so that reading one does
+        # not touch the data of its entries.
+        self._sums: Dict[int, int] = {}
+        self._entries_sum: Optional[int] = 0
         self.update_checksum()
 
     def __str__(self) -> str:
@@ -105,55 +115,128 @@ class TransferList:
             [
                 f"{k:<10} {hex(v)}"
                 for k, v in vars(self).items()
-                if not isinstance(v, list)
+                if not isinstance(v, list) and not k.startswith("_")
             ]
         )
 
+    @property
+    def entries(self) -> List[TransferEntry]:
+        return list(self._entries.values())
+
     def get_transfer_entries_str(self):
         return "\n----\n".join([str(te) for _, te in enumerate(self.entries)])
 
     @classmethod
-    def fromfile(cls, filepath: Path) -> "TransferList":
+    def fromfile(cls, filepath: Path, header_only: bool = False) -> "TransferList":
+        """Read a TL from a file.
+
+        The file is mapped into memory where possible, and the data of each TE
+        is a memoryview into the mapping rather than a copy. It is only copied
+        when the TL is written back to a file, see materialize().
+
+        :param filepath: Path of the TL blob.
+        :param header_only: Only read and parse the TL header, leaving the
+        list of entries empty.
+        """
         tl = cls()
 
         with open(filepath, "rb") as f:
-            (
-                tl.signature,
-                tl.checksum,
-                tl.version,
-                tl.hdr_size,
-                tl.alignment,
-                used_size,
-                tl.total_size,
-                tl.flags,
-                _,
-            ) = struct.unpack(
-                cls.encoding,
-                f.read(tl.hdr_size),
-            )
+            if header_only:
+                buf = memoryview(f.read(tl.hdr_size))
+            else:
+                buf = tl._map_file(f)
 
-            if tl.signature != TransferList.signature:
-                raise ValueError(f"Invalid TL signature 0x{tl.signature:x}!")
-            elif tl.version == 0 or tl.version > 0xFF:
-                raise ValueError(f"Invalid TL version 0x{tl.version:x}!")
+            used_size = tl._parse_header(buf)
+            if header_only:
+                tl.size = used_size
             else:
-                while tl.size < used_size:
-                    # We add an extra padding byte into the header so we can extract
-                    # the 3-byte wide ID as a 4-byte uint, shift out this padding
-                    # once we have the id.
-                    te_base = f.tell()
-                    (id, _, data_size) = struct.unpack(
-                        TransferEntry.encoding[0] + "I" + TransferEntry.encoding[1:],
-                        b"\x00" + f.read(TransferEntry.hdr_size),
-                    )
-
-                    id >>= 8
-                    te = tl.add_transfer_entry(id, f.read(data_size))
-                    te.offset = te_base
-                    f.seek(align(f.tell(), tl.granule))
+                tl._parse_entries(buf, used_size)
 
         return tl
 
+    def _map_file(self, f) -> memoryview:
+        """Map an open file read-only, falling back to reading it whole."""
+        try:
+            self._mapping = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        except (OSError, ValueError, TypeError, io.UnsupportedOperation):
+            # Empty files, pipes and file-like objects can't be mapped.
+            return memoryview(f.read())
+
+        return memoryview(self._mapping)
+
+    def _parse_header(self, buf: memoryview) -> int:
+        """Parse the TL header, returning the used size of the TL."""
+        if len(buf) < self.hdr_size:
+            raise ValueError("TL is smaller than its header!")
+
+        (
+            self.signature,
+            self.checksum,
+            self.version,
+            self.hdr_size,
+            self.alignment,
+            used_size,
+            self.total_size,
+            self.flags,
+            _,
+        ) = struct.unpack_from(self.encoding, buf)
+
+        if self.signature != TransferList.signature:
+            raise ValueError(f"Invalid TL signature 0x{self.signature:x}!")
+        elif self.version == 0 or self.version > 0xFF:
+            raise ValueError(f"Invalid TL version 0x{self.version:x}!")
+
+        return used_size
+
+    def _parse_entries(self, buf: memoryview, used_size: int) -> None:
+        self._entries_sum = None
+        if used_size > len(buf):
+            raise ValueError(f"TL size 0x{used_size:x} exceeds the file size!")
+
+        while self.size < used_size:
+            te_base = self.size
+            if te_base + TransferEntry.hdr_size > used_size:
+                raise ValueError(f"Truncated TE header at offset 0x{te_base:x}!")
+
+            # The tag ID is 3 bytes wide, read it together with the header
+            # size as a 4-byte uint and split them.
+            (id_hdr, data_size) = struct.unpack_from("<2I", buf, te_base)
+            id, hdr_size = id_hdr & 0xFFFFFF, id_hdr >> 24
+
+            data_base = te_base + hdr_size
+            if hdr_size < TransferEntry.hdr_size or data_base + data_size > used_size:
+                raise ValueError(f"Invalid TE at offset 0x{te_base:x}!")
+
+            te = TransferEntry(
+                id,
+                data_size,
+                buf[data_base : data_base + data_size],
+                hdr_size,
+                offset=te_base,
+            )
+            self._insert_entry(te)
+            self.size = align(data_base + data_size, self.granule)
+
+    def materialize(self) -> None:
+        """Copy the data of TEs read by fromfile() out of the file mapping.
+
+        This must be done before the file is modified, as changes to it would
+        otherwise show through the data of the entries, or fault if it is
+        truncated.
+        """
+        for te in self._entries.values():
+            if isinstance(te.data, memoryview):
+                te.data = bytes(te.data)
+
+        mapping = vars(self).pop("_mapping", None)
+        if mapping is not None:
+            try:
+                mapping.close()
+            except BufferError:
+                # A view of the data is still referenced outside the TL, the
+                # mapping is unmapped once that is released.
+                pass
+
     @classmethod
     def from_dict(cls, config: Dict[str, Any]) -> "TransferList":
         """Create a TL from data in a dictionary
@@ -202,18 +285,43 @@ class TransferList:
             self.checksum = 0
 
     def to_bytes(self) -> bytes:
-        return self.header_to_bytes() + b"".join([te.to_bytes() for te in self.entries])
+        return self.header_to_bytes() + b"".join(
+            [te.to_bytes() for te in self._entries.values()]
+        )
 
     def sum_of_bytes(self) -> int:
         """Sum of all bytes between the base address and the end of that last TE (modulo 0xff)."""
-        return (sum(self.to_bytes())) % 256
+        return (sum(self.header_to_bytes()) + self._get_entries_sum()) % 256
+
+    def _get_entries_sum(self) -> int:
+        if self._entries_sum is None:
+            self._sums = {key: te.sum_of_bytes for key, te in self._entries.items()}
+            self._entries_sum = sum(self._sums.values()) % 256
+
+        return self._entries_sum
+
+    def _insert_entry(self, te: TransferEntry) -> None:
+        """Append a TE to the list and its indices."""
+        key = id(te)
+        self._entries[key] = te
+        self._tags.setdefault(te.id, {})[key] = te
+
+        if self._entries_sum is not None:
+            self._sums[key] = te.sum_of_bytes
+            self._entries_sum = (self._entries_sum + self._sums[key]) % 256
+
+    def _drop_entry(self, te: TransferEntry) -> None:
+        """Remove a TE from the list, but not from the tag index."""
+        key = id(te)
+        del self._entries[key]
+
+        if self._entries_sum is not None:
+            self._entries_sum = (self._entries_sum - self._sums.pop(key)) % 256
 
     def get_entry(self, tag_id: int) -> Optional[TransferEntry]:
-        for te in self.entries:
-            if te.id == tag_id:
-                return te
+        tes = self._tags.get(tag_id)
 
-        return None
+        return next(iter(tes.values())) if tes else None
 
     def get_entry_data_offset(self, tag_id: int) -> int:
         """Returns offset of data of a TE from the base of the TL."""
@@ -245,7 +353,7 @@ class TransferList:
             )
 
         te = TransferEntry(tag_id, len(data), data, offset=self.size)
-        self.entries.append(te)
+        self._insert_entry(te)
 
         self.size += align(te.size, self.granule)
         if data_align > self.alignment:
@@ -370,9 +478,12 @@ class TransferList:
 
     def write_to_file(self, file: Path) -> None:
         """Write the contents of the TL to a file."""
+        # The file may be the one the TL was read from.
+        self.materialize()
+
         with open(file, "wb") as f:
             f.write(self.header_to_bytes())
-            for te in self.entries:
+            for te in self._entries.values():
                 assert f.tell() + te.hdr_size + te.data_size < self.total_size
 
                 f.write(te.header_to_bytes())
@@ -381,8 +492,10 @@ class TransferList:
                 f.write(bytes((align(f.tell(), self.granule) - f.tell())))
 
     def remove_tag(self, tag: int) -> None:
-        self.entries = list(filter(lambda te: te.id != tag, self.entries))
-        self.size = self.hdr_size + sum(map(lambda te: te.size, self.entries))
+        for te in self._tags.pop(tag, {}).values():
+            self._drop_entry(te)
+            self.size -= align(te.size, self.granule)
+
         self.update_checksum()
 
 